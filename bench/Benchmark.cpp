@@ -0,0 +1,418 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <filesystem>
+#include <stdexcept>
+#include <optional>
+#include <memory>
+#include <cstdint>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include "Generators.h"
+#include "Wheels.h"
+#include "Dictionary.h"
+#include "FlatDictionary.h"
+#include "DawgBuilder.h"
+#include "MappedFile.h"
+#include "Search.h"
+#include "Stats.h"
+#include "WordSet.h"
+#include "Utils.h"
+
+namespace
+{
+    /// The settings of a benchmark run, read from the CLI arguments.
+    struct Settings
+    {
+        size_t numberOfWheels = 12;
+        size_t lettersPerWheel = 8;
+        size_t numberOfWords = 100000;
+        size_t minimumLength = 2;
+        size_t maximumLength = 10;
+        Generators::DISTRIBUTION distribution = Generators::ENGLISH;
+        uint64_t seed = 1;
+        size_t threads = 1;
+        // The search engine and its settings.
+        Utils::Options search;
+        size_t repeat = 1;
+        std::string label = "default";
+        // Existing files to benchmark instead of generated ones.
+        std::string wheelsPath;
+        std::string dictionaryPath;
+        // The directory to write the generated files to, after which the benchmark exits without running.
+        std::string generateOnlyDirectory;
+        bool isJson = true;
+    };
+
+    const char* USAGE =
+        "Usage: LetteredWheelsBenchmark [options]\n"
+        "  --wheels N               number of generated wheels (default 12)\n"
+        "  --letters N              letters per generated wheel (default 8)\n"
+        "  --words N                number of generated dictionary words (default 100000)\n"
+        "  --min-length N           minimum generated word length (default 2)\n"
+        "  --max-length N           maximum generated word length (default 10)\n"
+        "  --distribution D         letter distribution: uniform or english (default english)\n"
+        "  --seed N                 seed of the generators (default 1)\n"
+        "  --threads N              search threads, 0 for every hardware thread (default 1)\n"
+        "  --engine NAME            search engine: dfs, bitmask or multistart (default dfs)\n"
+        "  --memoize                skip repeated (wheel, dictionary node) states in the dfs engine\n"
+        "  --dawg                   build the dictionary as a minimized DAWG instead of a trie\n"
+        "  --sort                   time writing the words in alphabetical order\n"
+        "  --count-only             time writing only the number of words found\n"
+        "  --repeat N               number of timed runs (default 1)\n"
+        "  --label NAME             label recorded with each run\n"
+        "  --wheels-file PATH       benchmark an existing wheels file instead of generating one\n"
+        "  --dictionary-file PATH   benchmark an existing dictionary file instead of generating one\n"
+        "  --generate-only DIR      write wheels.txt and dictionary.txt to DIR and exit\n"
+        "  --format F               report format: json or text (default json)\n";
+
+    size_t parseNumber(const std::string& option, const std::string& value)
+    {
+        const std::invalid_argument malformed("The option " + option + " expects a non-negative integer. Value: " + value);
+
+        if(value.empty() || value.find_first_not_of("0123456789") != std::string::npos)
+        {
+            throw malformed;
+        }
+
+        // A value too large for the type is reported as any other malformed value.
+        try
+        {
+            return std::stoull(value);
+        }
+        catch(const std::out_of_range&)
+        {
+            throw malformed;
+        }
+    }
+
+    Settings parseSettings(int argc, char* argv[])
+    {
+        Settings settings;
+
+        for(int i = 1; i < argc; i++)
+        {
+            const std::string option(argv[i]);
+
+            if(option == "--memoize")
+            {
+                settings.search.memoize = true;
+                continue;
+            }
+
+            if(option == "--dawg")
+            {
+                settings.search.dawg = true;
+                continue;
+            }
+
+            if(option == "--sort")
+            {
+                settings.search.sortOutput = true;
+                continue;
+            }
+
+            if(option == "--count-only")
+            {
+                settings.search.countOnly = true;
+                continue;
+            }
+
+            if(option == "--help")
+            {
+                std::cout << USAGE;
+                std::exit(0);
+            }
+
+            if(i + 1 >= argc)
+            {
+                throw std::invalid_argument("The option " + option + " expects a value.");
+            }
+
+            const std::string value(argv[++i]);
+
+            if(option == "--wheels") settings.numberOfWheels = parseNumber(option, value);
+            else if(option == "--letters") settings.lettersPerWheel = parseNumber(option, value);
+            else if(option == "--words") settings.numberOfWords = parseNumber(option, value);
+            else if(option == "--min-length") settings.minimumLength = parseNumber(option, value);
+            else if(option == "--max-length") settings.maximumLength = parseNumber(option, value);
+            else if(option == "--seed") settings.seed = parseNumber(option, value);
+            else if(option == "--threads") settings.threads = parseNumber(option, value);
+            else if(option == "--repeat") settings.repeat = parseNumber(option, value);
+            else if(option == "--label") settings.label = value;
+            else if(option == "--wheels-file") settings.wheelsPath = value;
+            else if(option == "--dictionary-file") settings.dictionaryPath = value;
+            else if(option == "--generate-only") settings.generateOnlyDirectory = value;
+            else if(option == "--distribution")
+            {
+                if(value != "uniform" && value != "english")
+                {
+                    throw std::invalid_argument("The option --distribution expects uniform or english. Value: " + value);
+                }
+
+                settings.distribution = value == "uniform" ? Generators::UNIFORM : Generators::ENGLISH;
+            }
+            else if(option == "--engine")
+            {
+                if(value != "dfs" && value != "bitmask" && value != "multistart")
+                {
+                    throw std::invalid_argument("The option --engine expects dfs, bitmask or multistart. Value: " + value);
+                }
+
+                settings.search.engine = value == "dfs" ? Utils::Options::DFS
+                    : value == "bitmask" ? Utils::Options::BITMASK : Utils::Options::MULTI_START;
+            }
+            else if(option == "--format")
+            {
+                if(value != "json" && value != "text")
+                {
+                    throw std::invalid_argument("The option --format expects json or text. Value: " + value);
+                }
+
+                settings.isJson = value == "json";
+            }
+            else
+            {
+                throw std::invalid_argument("Unrecognised option: " + option + "\n" + USAGE);
+            }
+        }
+
+        if(settings.minimumLength > settings.maximumLength || settings.numberOfWheels < 2 || settings.lettersPerWheel < 2)
+        {
+            throw std::invalid_argument("The word lengths must form a range, and there must be at least 2 wheels of 2 letters.");
+        }
+
+        return settings;
+    }
+
+    // Gets the peak resident set size of the process in bytes.
+    uint64_t getPeakResidentBytes(void)
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? counters.PeakWorkingSetSize : 0;
+#else
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+        return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+        // Linux reports kilobytes.
+        return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+    }
+
+    // Escapes a string for use inside a JSON string literal.
+    std::string escapeJson(const std::string& value)
+    {
+        std::string escaped;
+
+        for(char c : value)
+        {
+            if(c == '"' || c == '\\')
+            {
+                escaped.push_back('\\');
+            }
+
+            escaped.push_back(c);
+        }
+
+        return escaped;
+    }
+
+    // Measures the wall time of a callable in seconds.
+    template <typename Function>
+    double time(Function&& function)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // A stream buffer that discards everything written to it.
+    class NullBuffer : public std::streambuf
+    {
+      protected:
+        int overflow(int c) override
+        {
+            return traits_type::not_eof(c);
+        }
+
+        std::streamsize xsputn(const char*, std::streamsize count) override
+        {
+            return count;
+        }
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    Settings settings;
+
+    try
+    {
+        settings = parseSettings(argc, argv);
+    }
+    catch(const std::invalid_argument& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
+
+    const bool isGenerateOnly = !settings.generateOnlyDirectory.empty();
+    const std::filesystem::path directory = isGenerateOnly ? std::filesystem::path(settings.generateOnlyDirectory)
+        : std::filesystem::temp_directory_path() / ("lettered-wheels-benchmark-" + std::to_string(
+            std::chrono::steady_clock::now().time_since_epoch().count()));
+
+    std::filesystem::create_directories(directory);
+
+    const std::string wheelsPath = settings.wheelsPath.empty() ? (directory / "wheels.txt").string() : settings.wheelsPath;
+    const std::string dictionaryPath = settings.dictionaryPath.empty() ? (directory / "dictionary.txt").string() : settings.dictionaryPath;
+
+    try
+    {
+        Generators generators(settings.distribution, settings.seed);
+
+        if(settings.wheelsPath.empty())
+        {
+            generators.writeWheels(wheelsPath, settings.numberOfWheels, settings.lettersPerWheel);
+        }
+
+        if(settings.dictionaryPath.empty())
+        {
+            generators.writeDictionary(dictionaryPath, settings.numberOfWords, settings.minimumLength, settings.maximumLength);
+        }
+    }
+    catch(const std::runtime_error& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
+
+    if(isGenerateOnly)
+    {
+        return 0;
+    }
+
+    for(size_t run = 0; run < settings.repeat; run++)
+    {
+        std::unique_ptr<Wheels> wheels;
+        std::unique_ptr<FlatDictionary> dictionary;
+        std::optional<WordSet> result;
+
+        try
+        {
+            const double wheelParseSeconds = time([&]
+            {
+                std::ifstream file(wheelsPath);
+                wheels = std::make_unique<Wheels>(file);
+            });
+
+            const double dictionaryLoadSeconds = time([&]
+            {
+                const MappedFile file(dictionaryPath);
+
+                if(settings.search.dawg)
+                {
+                    dictionary = std::make_unique<FlatDictionary>(DawgBuilder::build(file, wheels->getNumberOfWheels()));
+                    return;
+                }
+
+                const Dictionary trie(file, wheels->getNumberOfWheels());
+                dictionary = std::make_unique<FlatDictionary>(trie);
+            });
+
+            const double searchSeconds = time([&]
+            {
+                result.emplace(Search::solve(*wheels, *dictionary, settings.search, settings.threads));
+            });
+
+            // The output is written to a discarding buffer, so the phase measures formatting rather than the terminal.
+            NullBuffer nullBuffer;
+            std::streambuf* const standardOutput = std::cout.rdbuf(&nullBuffer);
+            const double outputSeconds = time([&] { Utils::printResult(*result, settings.search); });
+            std::cout.rdbuf(standardOutput);
+
+            const uint64_t peakResidentBytes = getPeakResidentBytes();
+
+            // The candidates are counted by a second, untimed run of the same engine, so the timed search carries no counting.
+            Stats::Counters counters;
+
+            if(Stats::isEnabled())
+            {
+                Search::solve(*wheels, *dictionary, settings.search, settings.threads, &counters);
+            }
+
+            const uint64_t candidates = counters.candidates;
+
+            std::ostringstream report;
+
+            if(settings.isJson)
+            {
+                report << "{\"label\":\"" << escapeJson(settings.label) << "\",\"run\":" << run
+                    << ",\"wheels\":" << wheels->getNumberOfWheels() << ",\"letters_per_wheel\":" << wheels->getLettersPerWheel()
+                    << ",\"dictionary_nodes\":" << dictionary->getNodeCount() << ",\"dictionary_bytes\":" << dictionary->getSizeInBytes()
+                    << ",\"engine\":\"" << (settings.search.engine == Utils::Options::DFS ? "dfs"
+                        : settings.search.engine == Utils::Options::BITMASK ? "bitmask" : "multistart") << "\""
+                    << ",\"memoize\":" << (settings.search.memoize ? "true" : "false")
+                    << ",\"dawg\":" << (settings.search.dawg ? "true" : "false")
+                    << ",\"threads\":" << settings.threads
+                    << ",\"wheel_parse_s\":" << wheelParseSeconds << ",\"dictionary_load_s\":" << dictionaryLoadSeconds
+                    << ",\"search_s\":" << searchSeconds << ",\"output_s\":" << outputSeconds
+                    << ",\"candidates\":";
+
+                // Without the counters compiled in, the candidates are unknown.
+                if(Stats::isEnabled())
+                {
+                    report << candidates << ",\"candidates_per_s\":" << candidates / searchSeconds;
+                }
+                else
+                {
+                    report << "null,\"candidates_per_s\":null";
+                }
+
+                report << ",\"words_found\":" << result->size() << ",\"words_per_s\":" << result->size() / searchSeconds
+                    << ",\"peak_rss_bytes\":" << peakResidentBytes << "}";
+            }
+            else
+            {
+                report << settings.label << " run " << run << ": " << wheels->getNumberOfWheels() << "x" << wheels->getLettersPerWheel()
+                    << " wheels, " << dictionary->getNodeCount() << " nodes (" << dictionary->getSizeInBytes() << " bytes), "
+                    << settings.threads << " threads\n"
+                    << "  wheel parse     " << wheelParseSeconds << " s\n"
+                    << "  dictionary load " << dictionaryLoadSeconds << " s\n"
+                    << "  search          " << searchSeconds << " s (";
+
+                if(Stats::isEnabled())
+                {
+                    report << candidates / searchSeconds << " candidates/s, ";
+                }
+
+                report << result->size() / searchSeconds << " words/s)\n"
+                    << "  output          " << outputSeconds << " s\n"
+                    << "  peak RSS        " << peakResidentBytes << " bytes";
+            }
+
+            std::cout << report.str() << std::endl;
+        }
+        catch(const std::exception& e)
+        {
+            std::cerr << e.what() << std::endl;
+            std::filesystem::remove_all(directory);
+            return -1;
+        }
+    }
+
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,81 @@
+#include "Generators.h"
+
+#include <string>
+#include <fstream>
+#include <stdexcept>
+#include <array>
+
+namespace
+{
+    // The relative frequency of each letter A-Z in English text, in percent.
+    const std::array<double, Utils::LETTERS_IN_ALPHABET> ENGLISH_FREQUENCIES = {
+        8.2, 1.5, 2.8, 4.3, 12.7, 2.2, 2.0, 6.1, 7.0, 0.15, 0.77, 4.0, 2.4,
+        6.7, 7.5, 1.9, 0.095, 6.0, 6.3, 9.1, 2.8, 0.98, 2.4, 0.15, 2.0, 0.074
+    };
+}
+
+Generators::Generators(DISTRIBUTION distribution, uint64_t seed) : random(seed)
+{
+    if(distribution == ENGLISH)
+    {
+        letters = std::discrete_distribution<int>(ENGLISH_FREQUENCIES.begin(), ENGLISH_FREQUENCIES.end());
+    }
+    else
+    {
+        std::array<double, Utils::LETTERS_IN_ALPHABET> uniform;
+        uniform.fill(1.0);
+        letters = std::discrete_distribution<int>(uniform.begin(), uniform.end());
+    }
+}
+
+void Generators::writeWheels(const std::string& path, size_t numberOfWheels, size_t lettersPerWheel)
+{
+    std::ofstream file(path, std::ios::trunc);
+    std::string wheel(lettersPerWheel, 'A');
+
+    file << numberOfWheels << '\n' << lettersPerWheel << '\n';
+
+    for(size_t i = 0; i < numberOfWheels; i++)
+    {
+        for(char& letter : wheel)
+        {
+            letter = static_cast<char>('A' + nextLetter());
+        }
+
+        file << wheel << '\n';
+    }
+
+    if(!file)
+    {
+        throw std::runtime_error("Unable to write the wheels file with path : " + path);
+    }
+}
+
+void Generators::writeDictionary(const std::string& path, size_t numberOfWords, size_t minimumLength, size_t maximumLength)
+{
+    std::ofstream file(path, std::ios::trunc);
+    std::uniform_int_distribution<size_t> lengths(minimumLength, maximumLength);
+    std::string word;
+
+    for(size_t i = 0; i < numberOfWords; i++)
+    {
+        word.resize(lengths(random));
+
+        for(char& letter : word)
+        {
+            letter = static_cast<char>('a' + nextLetter());
+        }
+
+        file << word << '\n';
+    }
+
+    if(!file)
+    {
+        throw std::runtime_error("Unable to write the dictionary file with path : " + path);
+    }
+}
+
+int Generators::nextLetter(void)
+{
+    return letters(random);
+}
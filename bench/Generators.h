@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <random>
+#include <array>
+
+#include "Utils.h"
+
+/**
+ * Generates synthetic lettered wheels and dictionary files for benchmarking.
+ * 
+ * Letters are drawn from a configurable distribution over [A-Z], and the same seed always produces the same files.
+ */
+class Generators
+{
+  public:
+    /**
+     * The distributions letters can be drawn from.
+     * UNIFORM = every letter is equally likely.
+     * ENGLISH = letters are weighted by their frequency in English text.
+     */
+    enum DISTRIBUTION
+    {
+        UNIFORM,
+        ENGLISH
+    };
+
+    /**
+     * Constructor.
+     * 
+     * @param distribution: the distribution letters are drawn from
+     * @param seed: the seed of the random number generator
+     */
+    Generators(DISTRIBUTION distribution, uint64_t seed);
+    /**
+     * Writes a wheels .txt file in the format read by Wheels.
+     * 
+     * @param path: the file name/path to write to
+     * @param numberOfWheels: the number of wheels
+     * @param lettersPerWheel: the number of letters per wheel
+     */
+    void writeWheels(const std::string& path, size_t numberOfWheels, size_t lettersPerWheel);
+    /**
+     * Writes a dictionary .txt file of lowercase words, one per line. Words may repeat.
+     * 
+     * @param path: the file name/path to write to
+     * @param numberOfWords: the number of words
+     * @param minimumLength: the minimum length of a word
+     * @param maximumLength: the maximum length of a word
+     */
+    void writeDictionary(const std::string& path, size_t numberOfWords, size_t minimumLength, size_t maximumLength);
+
+  private:
+    std::mt19937_64 random;
+    std::discrete_distribution<int> letters;
+
+    // Draws a single letter from the distribution, as an index into the alphabet (A = 0, ..., Z = 25).
+    int nextLetter(void);
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+
+/**
+ * Helpers shared by the alphabet policies that the Dictionary and Wheels classes are templated on.
+ * 
+ * An alphabet policy is a class providing:
+ *   SIZE: the number of letters, at most 26, so that a set of letters fits the bits of a 32-bit mask
+ *   LETTERS: the letters in index order, in uppercase
+ *   INDEX: a 256-entry table mapping every byte to the index of its letter, folding case, or to INVALID
+ *   DESCRIPTION: the accepted characters, as written in error messages
+ * 
+ * A single INDEX lookup both validates a character and folds its case, with no locale-aware call.
+ * 
+ * Only LatinAlphabet is instantiated. FlatDictionary, its image, the search engines and the output hold letters as
+ * bits of 26-bit masks and spell them from [A-Z], so a reduced alphabet would need them templated on the policy too.
+ */
+class Alphabets
+{
+  public:
+    /// The INDEX entry of a byte that is not a letter of the alphabet.
+    static constexpr unsigned char INVALID = 0xFF;
+
+    /**
+     * Builds the INDEX table of an alphabet, accepting each of its letters in either case.
+     * 
+     * @param letters: the letters in index order, in uppercase
+     * @return the table mapping every byte to the index of its letter, or to INVALID
+     */
+    template <size_t N>
+    static constexpr std::array<unsigned char, 256> makeIndex(const char (&letters)[N])
+    {
+        std::array<unsigned char, 256> index = {};
+
+        for(unsigned char& entry : index)
+        {
+            entry = INVALID;
+        }
+
+        // The final character is the terminating null.
+        for(size_t i = 0; i + 1 < N; i++)
+        {
+            const unsigned char upper = static_cast<unsigned char>(letters[i]);
+
+            index[upper] = static_cast<unsigned char>(i);
+            index[upper - 'A' + 'a'] = static_cast<unsigned char>(i);
+        }
+
+        return index;
+    }
+
+    /**
+     * Determines whether all characters in the given string are letters of an alphabet.
+     * 
+     * @param str: the string to query
+     * @return true if every character is a letter of the alphabet, in either case, else false
+     */
+    template <typename Policy>
+    static constexpr bool isValidString(std::string_view str)
+    {
+        for(char c : str)
+        {
+            if(Policy::INDEX[static_cast<unsigned char>(c)] == INVALID)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Checks that a word read from a dictionary holds only letters of an alphabet, before it is added to a dictionary.
+     * 
+     * An exception will be thrown, naming the word and the accepted characters, if the word holds any other character.
+     * 
+     * @param word: the word to check
+     */
+    template <typename Policy>
+    static void validateWord(std::string_view word)
+    {
+        if(!isValidString<Policy>(word))
+        {
+            std::string arg;
+            arg.append("Encountered a character in the word \"").append(word).
+                append("\" not in the expected range of ").append(Policy::DESCRIPTION).append(".\n").append(
+                    "Aborting insertion of the dictionary.\n");
+
+            throw std::invalid_argument(arg);
+        }
+    }
+};
+
+/// The 26 letters of the Latin alphabet, [A-Z].
+struct LatinAlphabet
+{
+    static constexpr size_t SIZE = 26;
+    static constexpr char LETTERS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    static constexpr std::array<unsigned char, 256> INDEX = Alphabets::makeIndex(LETTERS);
+    static constexpr const char* DESCRIPTION = "{[a-z][A-Z]}";
+};
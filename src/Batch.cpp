@@ -0,0 +1,150 @@
+#include "Batch.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <filesystem>
+#include <stdexcept>
+#include <algorithm>
+
+#include "Wheels.h"
+#include "FlatDictionary.h"
+#include "DictionaryLoader.h"
+#include "Search.h"
+#include "WorkStealingPool.h"
+#include "Utils.h"
+
+namespace
+{
+    // A single puzzle of the batch.
+    struct Puzzle
+    {
+        std::string path;
+        // The parsed wheels, or nullptr if the wheels file could not be read.
+        std::unique_ptr<Wheels> wheels;
+        // The formatted result of the puzzle, kept until it is written to the console.
+        std::string output;
+        // Why the result file could not be written, or empty if it was.
+        std::string error;
+    };
+}
+
+size_t Batch::solve(const Utils::Options& options)
+{
+    std::ifstream batchFile(options.batchPath);
+
+    if(batchFile.fail())
+    {
+        throw std::invalid_argument("Unable to locate / access the file with path : " + options.batchPath);
+    }
+
+    std::vector<Puzzle> puzzles;
+    std::string line;
+
+    while(std::getline(batchFile, line))
+    {
+        // Ignores the carriage return of a line ending in "\r\n".
+        if(!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+
+        if(!line.empty())
+        {
+            puzzles.push_back({ line, nullptr, "", "" });
+        }
+    }
+
+    size_t failures = 0;
+    // The dictionary only needs words as long as the widest puzzle can form.
+    size_t maximumWordSize = 2;
+
+    for(Puzzle& puzzle : puzzles)
+    {
+        std::ifstream wheelsFile(puzzle.path);
+
+        try
+        {
+            if(wheelsFile.fail())
+            {
+                throw std::invalid_argument("Unable to locate / access the file with path : " + puzzle.path);
+            }
+
+            puzzle.wheels = std::make_unique<Wheels>(wheelsFile);
+            maximumWordSize = std::max(maximumWordSize, puzzle.wheels->getNumberOfWheels());
+        }
+        catch(const std::exception& e)
+        {
+            std::cerr << "Skipping the puzzle " << puzzle.path << ": " << e.what() << std::endl;
+            failures++;
+        }
+    }
+
+    const std::unique_ptr<FlatDictionary> dictionary = DictionaryLoader::load(options, maximumWordSize);
+
+    if(!options.outputDirectory.empty())
+    {
+        std::filesystem::create_directories(options.outputDirectory);
+    }
+
+    // Each puzzle is searched sequentially, so the puzzles themselves are spread across the threads.
+    WorkStealingPool pool(options.threads);
+
+    pool.run(puzzles.size(), [&](size_t, size_t index)
+    {
+        Puzzle& puzzle = puzzles[index];
+
+        if(puzzle.wheels == nullptr)
+        {
+            return;
+        }
+
+        std::ostringstream output;
+        Utils::printResult(Search::solve(*puzzle.wheels, *dictionary, options, 1), options, output);
+        puzzle.wheels.reset();
+
+        if(options.outputDirectory.empty())
+        {
+            puzzle.output = output.str();
+            return;
+        }
+
+        // The puzzle's position in the batch keeps the names unique when wheels files share a name.
+        const std::filesystem::path resultPath = std::filesystem::path(options.outputDirectory)
+            / (std::to_string(index) + "-" + std::filesystem::path(puzzle.path).stem().string() + ".txt");
+        std::ofstream resultFile(resultPath, std::ios::trunc);
+
+        resultFile << output.str();
+
+        // Like an unreadable puzzle, a result that cannot be written is reported once the batch is solved.
+        if(!resultFile)
+        {
+            puzzle.error = "Unable to write the result file with path : " + resultPath.string();
+        }
+    });
+
+    for(const Puzzle& puzzle : puzzles)
+    {
+        if(!puzzle.error.empty())
+        {
+            std::cerr << "Skipping the result of the puzzle " << puzzle.path << ": " << puzzle.error << std::endl;
+            failures++;
+        }
+    }
+
+    if(options.outputDirectory.empty())
+    {
+        for(const Puzzle& puzzle : puzzles)
+        {
+            if(!puzzle.output.empty())
+            {
+                std::cout << "Puzzle: " << puzzle.path << "\n" << puzzle.output;
+            }
+        }
+    }
+
+    return failures;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Utils.h"
+
+/// Solves many lettered wheels puzzles against a single dictionary.
+class Batch
+{
+  public:
+    /**
+     * Solves every wheels file listed in the batch file, one path per line, against a dictionary that is built
+     * or loaded once for the whole batch.
+     * 
+     * Puzzles are solved concurrently when more than one thread is requested. The result of each puzzle is written
+     * to the console in the order the puzzles are listed, each preceded by the path of its wheels file, or to its
+     * own file in the output directory if one is provided. A puzzle that cannot be read is reported and skipped.
+     * 
+     * An exception will be thrown if the batch file or the dictionary cannot be read.
+     * 
+     * @param options: the options read from the CLI arguments
+     * @return the number of puzzles that could not be read, or whose result could not be written
+     */
+    static size_t solve(const Utils::Options& options);
+};
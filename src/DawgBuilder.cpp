@@ -0,0 +1,170 @@
+#include "DawgBuilder.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <assert.h>
+
+#include "FlatDictionary.h"
+#include "Dictionary.h"
+#include "MappedFile.h"
+#include "Alphabet.h"
+
+DawgBuilder::DawgBuilder(const size_t maximumWordSize) :
+    maximumWordSize(maximumWordSize), path(1), nodes(1), registry(0, NodeHash{ this }, NodeEqual{ this })
+{
+}
+
+FlatDictionary DawgBuilder::build(const MappedFile& file, const size_t maximumWordSize, const Wheels* wheels)
+{
+    const std::string_view contents = file.getContents();
+    std::vector<std::string_view> words;
+
+    // The words are validated in file order, so the first invalid word is reported as the trie reports it.
+    Dictionary::forEachWord(contents.data(), contents.data() + contents.size(), maximumWordSize, wheels,
+        [&](std::string_view word)
+    {
+        words.push_back(word);
+    });
+
+    // Words are added in alphabetical order, regardless of case.
+    std::sort(words.begin(), words.end(), [](std::string_view first, std::string_view second)
+    {
+        return std::lexicographical_compare(first.begin(), first.end(), second.begin(), second.end(),
+            [](char a, char b)
+            {
+                return LatinAlphabet::INDEX[static_cast<unsigned char>(a)] < LatinAlphabet::INDEX[static_cast<unsigned char>(b)];
+            });
+    });
+
+    DawgBuilder builder(maximumWordSize);
+
+    for(std::string_view word : words)
+    {
+        builder.insert(word);
+    }
+
+    return builder.finish();
+}
+
+void DawgBuilder::insert(std::string_view word)
+{
+    // build() has validated the word.
+    assert(Alphabets::isValidString<LatinAlphabet>(word));
+
+    std::string upper(word);
+    std::transform(upper.begin(), upper.end(), upper.begin(), [](char c)
+    {
+        return LatinAlphabet::LETTERS[LatinAlphabet::INDEX[static_cast<unsigned char>(c)]];
+    });
+
+    // build() sorts the words before adding them.
+    assert(upper >= previousWord);
+
+    if(upper == previousWord)
+    {
+        return;
+    }
+
+    // The length of the prefix shared with the previous word. The rest of the previous word is final.
+    const size_t common = std::mismatch(upper.begin(), upper.end(), previousWord.begin(), previousWord.end()).first - upper.begin();
+
+    minimize(common);
+
+    for(size_t i = common; i < upper.size(); i++)
+    {
+        path.back().mask |= 1u << LatinAlphabet::INDEX[static_cast<unsigned char>(upper[i])];
+        path.emplace_back();
+    }
+
+    path.back().mask |= FlatDictionary::WORD_FLAG;
+    previousWord = std::move(upper);
+}
+
+FlatDictionary DawgBuilder::finish(void)
+{
+    minimize(0);
+
+    // The root is never shared, so it takes its reserved place without being registered.
+    nodes[FlatDictionary::ROOT] = { path[0].mask, static_cast<uint32_t>(edges.size()) };
+    edges.insert(edges.end(), path[0].children.begin(), path[0].children.end());
+
+    FlatDictionary dictionary(std::move(nodes), std::move(edges), maximumWordSize);
+
+    registry.clear();
+    previousWord.clear();
+    path.assign(1, PendingNode());
+    nodes.assign(1, FlatDictionary::Node());
+    edges.clear();
+
+    return dictionary;
+}
+
+void DawgBuilder::minimize(size_t depth)
+{
+    while(path.size() > depth + 1)
+    {
+        const uint32_t node = registerNode(path.back());
+
+        path.pop_back();
+        path.back().children.push_back(node);
+    }
+}
+
+uint32_t DawgBuilder::registerNode(const PendingNode& node)
+{
+    // The 32-bit indices leave NO_NODE free as a sentinel.
+    if(nodes.size() >= FlatDictionary::NO_NODE)
+    {
+        throw std::length_error("The dictionary has too many nodes to be stored in a flat structure.");
+    }
+
+    // The node is laid out as a candidate, and withdrawn if an identical node is already registered.
+    const uint32_t candidate = static_cast<uint32_t>(nodes.size());
+
+    nodes.push_back({ node.mask, static_cast<uint32_t>(edges.size()) });
+    edges.insert(edges.end(), node.children.begin(), node.children.end());
+
+    const auto [registered, isNew] = registry.insert(candidate);
+
+    if(!isNew)
+    {
+        edges.resize(nodes.back().firstEdge);
+        nodes.pop_back();
+    }
+
+    return *registered;
+}
+
+size_t DawgBuilder::NodeHash::operator()(uint32_t node) const
+{
+    const FlatDictionary::Node& entry = builder->nodes[node];
+    const uint32_t* const children = builder->edges.data() + entry.firstEdge;
+    size_t hash = entry.mask;
+
+    for(int i = 0; i < std::popcount(entry.mask & FlatDictionary::LETTER_MASK); i++)
+    {
+        hash = hash * 1000003 ^ children[i];
+    }
+
+    return hash;
+}
+
+bool DawgBuilder::NodeEqual::operator()(uint32_t first, uint32_t second) const
+{
+    const FlatDictionary::Node& firstEntry = builder->nodes[first];
+    const FlatDictionary::Node& secondEntry = builder->nodes[second];
+
+    if(firstEntry.mask != secondEntry.mask)
+    {
+        return false;
+    }
+
+    // Equal masks have the same number of children.
+    return std::memcmp(builder->edges.data() + firstEntry.firstEdge, builder->edges.data() + secondEntry.firstEdge,
+        std::popcount(firstEntry.mask & FlatDictionary::LETTER_MASK) * sizeof(uint32_t)) == 0;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_set>
+#include <cstdint>
+
+#include "FlatDictionary.h"
+#include "MappedFile.h"
+#include "Wheels.h"
+
+/**
+ * Builds a FlatDictionary laid out as a DAWG: a minimized acyclic automaton in which words share the nodes of
+ * their common prefixes and of their common suffixes.
+ * 
+ * Words are added in alphabetical order and the automaton is minimized as it grows (the incremental algorithm of
+ * Daciuk et al.). Once a word is added, the nodes of the previous word that it does not share can no longer change,
+ * so each is replaced by an identical node already built, or registered as a new one. Only the nodes of the most
+ * recent word are ever held unminimized, so a lexicon never needs the memory of its full trie.
+ */
+class DawgBuilder
+{
+  public:
+    /**
+     * Builds a DAWG of the words read in place from the provided memory mapped dictionary .txt file.
+     * The words may be in any order; they are sorted before they are added.
+     * Lines may end with "\n" or "\r\n".
+     * The words added must be in the range: 2 <= {word length} <= maximumWordSize.
+     * If wheels are provided, the words they cannot form are left out before sorting.
+     * 
+     * An exception will be thrown, naming the first such word in the file, if a word holds a character outside the range {[a-z][A-Z]}.
+     * 
+     * @param file: the mapped dictionary .txt file to encode
+     * @param maximumWordSize: the maximum length of words that will be stored
+     * @param wheels: the wheels the dictionary will be searched with, or nullptr to store every word
+     * @return the dictionary laid out as a DAWG
+     */
+    static FlatDictionary build(const MappedFile& file, size_t maximumWordSize, const Wheels* wheels = nullptr);
+  private:
+    /**
+     * Constructor for an empty automaton.
+     * 
+     * @param maximumWordSize: the maximum length of the words read from the dictionary file, recorded in the result
+     */
+    explicit DawgBuilder(size_t maximumWordSize);
+
+    DawgBuilder(const DawgBuilder&) = delete;
+    DawgBuilder& operator=(const DawgBuilder&) = delete;
+
+    /**
+     * Adds a word to the automaton. Letters are compared regardless of case, and a repeated word is ignored.
+     * 
+     * @param word: the word to add, holding only letters in the range {[a-z][A-Z]} and sorting at or after every word
+     * added before it
+     */
+    void insert(std::string_view word);
+    /**
+     * Minimizes the remaining nodes and lays the automaton out as a FlatDictionary.
+     * The builder is left without words.
+     * 
+     * @return the dictionary laid out as a DAWG
+     */
+    FlatDictionary finish(void);
+
+    // A node on the path of the most recent word, which may still gain children.
+    struct PendingNode
+    {
+        // The letters that have a child, and the word flag.
+        uint32_t mask = 0;
+        // The ids of the children already minimized, ordered by letter. The child for the highest letter
+        // is the next node on the path, until it is minimized too.
+        std::vector<uint32_t> children;
+    };
+
+    // Hashes a registered node by its mask and children.
+    struct NodeHash
+    {
+        const DawgBuilder* builder;
+        size_t operator()(uint32_t node) const;
+    };
+
+    // Compares two registered nodes by their masks and children.
+    struct NodeEqual
+    {
+        const DawgBuilder* builder;
+        bool operator()(uint32_t first, uint32_t second) const;
+    };
+
+    const size_t maximumWordSize;
+    // The most recent word added, in uppercase.
+    std::string previousWord;
+    // The unminimized nodes of the most recent word, from the root.
+    std::vector<PendingNode> path;
+    // The minimized nodes and their edges. The first node is reserved for the root, which is laid out last.
+    std::vector<FlatDictionary::Node> nodes;
+    std::vector<uint32_t> edges;
+    // The ids of the minimized nodes, so that an identical node is found in constant time.
+    std::unordered_set<uint32_t, NodeHash, NodeEqual> registry;
+
+    // Minimizes the nodes of the path deeper than the given depth.
+    void minimize(size_t depth);
+    // Gets the id of a minimized node identical to the pending node, registering it if there is none.
+    uint32_t registerNode(const PendingNode& node);
+};
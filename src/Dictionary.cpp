@@ -3,39 +3,67 @@
 #include <array>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <cstring>
 #include <fstream>
+#include <vector>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
 #include <assert.h>
-#include <cctype>
 
 #include "Utils.h"
+#include "Alphabet.h"
+#include "Wheels.h"
+#include "WorkStealingPool.h"
 
-std::array<std::unique_ptr<Dictionary::Node>, Utils::LETTERS_IN_ALPHABET>& Dictionary::Node::GetArray() {
+template <typename Alphabet>
+std::array<std::unique_ptr<typename BasicDictionary<Alphabet>::Node>, Alphabet::SIZE>& BasicDictionary<Alphabet>::Node::GetArray() {
 	return letters;
 }
 
-bool Dictionary::Node::getIsWord(void) const
+template <typename Alphabet>
+const typename BasicDictionary<Alphabet>::Node* BasicDictionary<Alphabet>::Node::getChild(unsigned char index) const
+{
+    return letters[index].get();
+}
+
+template <typename Alphabet>
+bool BasicDictionary<Alphabet>::Node::getIsWord(void) const
 {
     return isWord;
 }
 
-void Dictionary::Node::setIsWord(bool b)
+template <typename Alphabet>
+void BasicDictionary<Alphabet>::Node::setIsWord(bool b)
 {
     isWord = b;
 }
 
-bool Dictionary::Node::getIsTerminal(void) const
+template <typename Alphabet>
+bool BasicDictionary<Alphabet>::Node::getIsTerminal(void) const
 {
-    return isTerminal;
+    return childMask == 0;
 }
 
-void Dictionary::Node::setIsNotTerminal(void)
+template <typename Alphabet>
+uint32_t BasicDictionary<Alphabet>::Node::getChildMask(void) const
 {
-    isTerminal = false;
+    return childMask;
 }
 
-Dictionary::Dictionary(void) : root(std::make_unique<Node>()) {}
+template <typename Alphabet>
+void BasicDictionary<Alphabet>::Node::setHasChild(unsigned char index)
+{
+    childMask |= 1u << index;
+}
+
+template <typename Alphabet>
+BasicDictionary<Alphabet>::BasicDictionary(void) : root(std::make_unique<Node>()) {}
 
-Dictionary::Dictionary(std::ifstream& file, const size_t maximumWordSize) : root(std::make_unique<Dictionary::Node>())
+template <typename Alphabet>
+BasicDictionary<Alphabet>::BasicDictionary(std::ifstream& file, const size_t maximumWordSize) :
+    root(std::make_unique<Node>()), maximumWordSize(maximumWordSize)
 {
     std::string word;
 
@@ -44,46 +72,136 @@ Dictionary::Dictionary(std::ifstream& file, const size_t maximumWordSize) : root
         // Ensures words inserted in the dictionary are in range 2 <= word length <= maximumWordSize.
         if(word.length() > 1 && word.length() <= maximumWordSize)
         {
-            Dictionary::insert(word);
+            insert(word);
         }
     }
 }
 
-void Dictionary::insert(const std::string& word) const
+template <typename Alphabet>
+BasicDictionary<Alphabet>::BasicDictionary(const MappedFile& file, const size_t maximumWordSize,
+    const BasicWheels<Alphabet>* wheels, const size_t threads) :
+    root(std::make_unique<Node>()), maximumWordSize(maximumWordSize)
+{
+    const std::string_view contents = file.getContents();
+
+    if(threads != 1)
+    {
+        insertInParallel(contents, wheels, threads);
+        return;
+    }
+
+    forEachWord(contents.data(), contents.data() + contents.size(), maximumWordSize, wheels, [&](std::string_view word)
+    {
+        insert(word);
+    });
+}
+
+template <typename Alphabet>
+void BasicDictionary<Alphabet>::insertInParallel(std::string_view contents, const BasicWheels<Alphabet>* wheels,
+    const size_t threads)
 {
-    // Ensures given character contains only {[a-z][A-Z]}.
-    if (!Utils::isValidString(word))
+    WorkStealingPool pool(threads);
+    const size_t chunkCount = pool.getThreadCount();
+
+    // Splits the file into one chunk per thread, each starting at the beginning of a line.
+    std::vector<const char*> bounds(chunkCount + 1, contents.data() + contents.size());
+    bounds[0] = contents.data();
+
+    for(size_t chunk = 1; chunk < chunkCount; chunk++)
     {
-        std::string arg;
-        arg.append("Encountered a character in the word \"").append({ word }).
-            append("\" not in the expected range of {[a-z][A-Z]}.\n").append(
-                "Aborting insertion of the dictionary.\n");
+        const char* start = std::max(bounds[chunk - 1], contents.data() + contents.size() * chunk / chunkCount);
+        const char* lineEnd = static_cast<const char*>(std::memchr(start, '\n', contents.data() + contents.size() - start));
 
-        throw std::invalid_argument(arg);
+        bounds[chunk] = lineEnd == nullptr ? contents.data() + contents.size() : lineEnd + 1;
     }
 
-    Node* node = root.get();
+    // The words of each chunk, by first letter, and the error of each chunk that holds an invalid word.
+    std::vector<std::vector<std::vector<std::string_view>>> shards(chunkCount,
+        std::vector<std::vector<std::string_view>>(Alphabet::SIZE));
+    std::vector<std::exception_ptr> errors(chunkCount);
 
+    pool.run(chunkCount, [&](size_t, size_t chunk)
+    {
+        try
+        {
+            forEachWord(bounds[chunk], bounds[chunk + 1], maximumWordSize, wheels, [&](std::string_view word)
+            {
+                shards[chunk][Alphabet::INDEX[static_cast<unsigned char>(word[0])]].push_back(word);
+            });
+        }
+        catch(const std::invalid_argument&)
+        {
+            errors[chunk] = std::current_exception();
+        }
+    });
+
+    // Reports the first invalid word in the file, before any node is created.
+    for(const std::exception_ptr& error : errors)
+    {
+        if(error != nullptr)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // Each first letter's subtrie is built apart from the others, so the shards need no synchronisation.
+    std::vector<std::unique_ptr<Node>> subtries(Alphabet::SIZE);
+
+    pool.run(Alphabet::SIZE, [&](size_t, size_t letter)
+    {
+        for(const auto& chunk : shards)
+        {
+            for(std::string_view word : chunk[letter])
+            {
+                if(subtries[letter] == nullptr)
+                {
+                    subtries[letter] = std::make_unique<Node>();
+                }
+
+                insertUnder(subtries[letter].get(), word.substr(1));
+            }
+        }
+    });
+
+    for(unsigned char letter = 0; letter < Alphabet::SIZE; letter++)
+    {
+        if(subtries[letter] != nullptr)
+        {
+            root->GetArray()[letter] = std::move(subtries[letter]);
+            root->setHasChild(letter);
+        }
+    }
+}
+
+template <typename Alphabet>
+void BasicDictionary<Alphabet>::insert(std::string_view word) const
+{
+    // Ensures given character contains only letters of the alphabet, before any node is created.
+    Alphabets::validateWord<Alphabet>(word);
+
+    insertUnder(root.get(), word);
+}
+
+template <typename Alphabet>
+void BasicDictionary<Alphabet>::insertUnder(Node* node, std::string_view letters)
+{
     // Iterates through each character in the input word.
-    for(size_t i = 0; i < word.length(); i++)
+    for(size_t i = 0; i < letters.length(); i++)
     {
         auto& arr = node->GetArray();
 
-        // The lowercase character index in the alphabet.
-        unsigned char c = (std::toupper(word[i]) - 'A');
+        // The character's index in the alphabet, whatever its case.
+        unsigned char c = Alphabet::INDEX[static_cast<unsigned char>(letters[i])];
 
-        assert(c >= 0 && c <= 25);
+        assert(c < Alphabet::SIZE);
         // The current location in the array is not occupied, so fill it.
         if(arr[c] == nullptr)
         {
             // Create a new node and insert in the array.
             arr[c] = std::make_unique<Node>();
 
-            // Set previous node to not be a terminal node.
-            if(node->getIsTerminal())
-            {
-                node->setIsNotTerminal();
-            }
+            // Set previous node to not be a terminal node, recording the new child in its mask.
+            node->setHasChild(c);
         }
 
         // Gets the raw pointer to the node just inserted in the array and makes it the current node.
@@ -93,25 +211,26 @@ void Dictionary::insert(const std::string& word) const
     node->setIsWord(true);
 }
 
-Dictionary::SEARCH_STATUS Dictionary::find(const std::string& word)
+template <typename Alphabet>
+DictionaryBase::SEARCH_STATUS BasicDictionary<Alphabet>::find(const std::string& word)
 {
-    // Immediately returns a MISS if the word to find is not in the expected format.
-    if(!Utils::isValidString(word))
-    {
-        return MISS;
-    }
-
-    Dictionary::Node* node = root.get();
+    Node* node = root.get();
 
     // Iterate through each letter in the word.
     for(size_t i = 0; i < word.length(); i++)
     {
-        // The character's index in the alphabet.
-        // A = 0, B = 1, ..., Z = 25.
-        unsigned char c = (std::toupper(word[i]) - 'A');
+        // The character's index in the alphabet, whatever its case.
+        // For the Latin alphabet, A = 0, B = 1, ..., Z = 25.
+        unsigned char c = Alphabet::INDEX[static_cast<unsigned char>(word[i])];
+
+        // Immediately returns a MISS if the word to find is not in the expected format.
+        if(c == Alphabets::INVALID)
+        {
+            return MISS;
+        }
+
         auto& arr = node->GetArray();
 
-        assert(c >= 0 && c <= 25);
         // The letter that has attempted to be found is not present in the structure.
         if(arr[c] == nullptr)
         {
@@ -122,8 +241,26 @@ Dictionary::SEARCH_STATUS Dictionary::find(const std::string& word)
         node = arr[c].get();
     }
 
+    return statusOf(node);
+}
+
+template <typename Alphabet>
+size_t BasicDictionary<Alphabet>::getMaximumWordSize(void) const
+{
+    return maximumWordSize;
+}
+
+template <typename Alphabet>
+DictionaryBase::SEARCH_STATUS BasicDictionary<Alphabet>::statusOf(const Node* node)
+{
+    // A letter in the word was absent from the structure.
+    if(node == nullptr)
+    {
+        return MISS;
+    }
+
     // Node is terminal node - it does not have any children and it is a word.
-    if(node->isTerminal)
+    if(node->getIsTerminal())
     {
         return HIT_TERMINAL;
     }
@@ -131,4 +268,66 @@ Dictionary::SEARCH_STATUS Dictionary::find(const std::string& word)
     // This node is a parent because the final letter in the word is present in the structure, but not a terminal node.
     // If the final node has been labelled as a word, return HIT_PARENT, else MISS_PARENT.
     return node->getIsWord() ? HIT_PARENT : MISS_PARENT;
-}
\ No newline at end of file
+}
+
+template <typename Alphabet>
+BasicDictionary<Alphabet>::Cursor::Cursor(const BasicDictionary& dictionary)
+{
+    path.push_back(dictionary.root.get());
+}
+
+template <typename Alphabet>
+DictionaryBase::SEARCH_STATUS BasicDictionary<Alphabet>::Cursor::descend(char letter)
+{
+    const Node* node = path.back();
+
+    // Once a letter is missing, every longer word is missing too.
+    if(node != nullptr)
+    {
+        // The character's index in the alphabet, or INVALID for a character outside it.
+        unsigned char c = Alphabet::INDEX[static_cast<unsigned char>(letter)];
+
+        node = c < Alphabet::SIZE ? node->getChild(c) : nullptr;
+    }
+
+    path.push_back(node);
+
+    return statusOf(node);
+}
+
+template <typename Alphabet>
+void BasicDictionary<Alphabet>::Cursor::ascend(void)
+{
+    // The root is never removed.
+    if(path.size() > 1)
+    {
+        path.pop_back();
+    }
+}
+
+template <typename Alphabet>
+void BasicDictionary<Alphabet>::Cursor::reset(void)
+{
+    path.resize(1);
+}
+
+template <typename Alphabet>
+DictionaryBase::SEARCH_STATUS BasicDictionary<Alphabet>::Cursor::status(void) const
+{
+    return statusOf(path.back());
+}
+
+template <typename Alphabet>
+uint32_t BasicDictionary<Alphabet>::Cursor::getChildMask(void) const
+{
+    return path.back() == nullptr ? 0 : path.back()->getChildMask();
+}
+
+template <typename Alphabet>
+size_t BasicDictionary<Alphabet>::Cursor::depth(void) const
+{
+    return path.size() - 1;
+}
+
+// The alphabet the dictionary is built on. See Alphabet.h.
+template class BasicDictionary<LatinAlphabet>;
@@ -1,65 +1,93 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <array>
 #include <memory>
+#include <vector>
+#include <cstdint>
 
 #include "Utils.h"
+#include "Alphabet.h"
+#include "MappedFile.h"
+
+template <typename Alphabet>
+class BasicWheels;
+
+/// The search states shared by every dictionary, whichever alphabet it is built on.
+class DictionaryBase
+{
+  public:
+      /**
+       * These values represent the result states of a search in the Dictionary structure (using find(std::string word)).
+       * HIT_TERMINAL = a word has been found, and the final node is a terminal node in the Dictionary.
+       * HIT_PARENT = a word has been found, and the final node is a parent node.
+       * MISS_PARENT = a word has not been found, and the final node is a parent node.
+       * MISS = a word could not be found and somewhere in the search a null node was inspecting - indicating an absence from the Dictionary.
+       */
+      enum SEARCH_STATUS
+      {
+         HIT_TERMINAL,
+         HIT_PARENT,
+         MISS_PARENT,
+         MISS
+      };
+};
 
 /**
  * This structure represents a dictionary and is used to cross-reference words generated by the lettered wheels.
  * 
- * All words are expected to be in the range [a-z][A-Z] and only the words 2 <= {word length} <= letters_per_wheel are inserted.
+ * All words are expected to be made of the letters of the Alphabet policy (see Alphabet.h), in either case, and only
+ * the words 2 <= {word length} <= letters_per_wheel are inserted. Each node holds one child per letter of the alphabet,
+ * so a reduced alphabet gives proportionally smaller nodes.
  * Words are expected to be formatted on a new line.
+ * 
+ * The structure is instantiated for LatinAlphabet, as Dictionary.
  */
-class Dictionary
+template <typename Alphabet>
+class BasicDictionary : public DictionaryBase
 {
+    static_assert(Alphabet::SIZE <= 26, "A set of letters must fit in the bits of a child mask.");
+
+    // Allows the FlatDictionary class to traverse the structure from its root.
+    friend class FlatDictionary;
+
     /**
      * A single node in the Dictionary data structure, and represents an individual character.
-     * A node is comprised of an array of 26 Node pointers, that when filled at a particular index, indicates
-     * a subsequent letter in a string.
+     * A node is comprised of an array of Node pointers, one per letter of the alphabet, that when filled at a
+     * particular index, indicates a subsequent letter in a string.
      */
     class Node
     {
         // Allows the Dictionary class to access all private members of the inner Node class.
-        friend class Dictionary;
+        friend class BasicDictionary;
+        // Allows the FlatDictionary class to read the nodes it compiles.
+        friend class FlatDictionary;
 
       private:
         // Initialies the Node poiters to nullptr.
-        std::array<std::unique_ptr<Node>, Utils::LETTERS_IN_ALPHABET> letters = {};
+        std::array<std::unique_ptr<Node>, Alphabet::SIZE> letters = {};
         // True if this node is the end node in a word, else false.
         bool isWord = false;
-        // True if this node is the final node in the chain.
-        // This implies the path generated to reach the node is a word, and that all nodes in its array are null.
-        bool isTerminal = true;
+        // Flags the letters (bit 0 for the first letter of the alphabet, and so on) that have a node in the array.
+        // A node without children is the final node in the chain, which implies the path generated to reach the node is a word.
+        uint32_t childMask = 0;
 
-        std::array<std::unique_ptr<Node>, Utils::LETTERS_IN_ALPHABET>& GetArray();
+        std::array<std::unique_ptr<Node>, Alphabet::SIZE>& GetArray();
+        const Node* getChild(unsigned char index) const;
         bool getIsWord(void) const;
         void setIsWord(bool b);
         bool getIsTerminal(void) const;
-        void setIsNotTerminal(void);
+        uint32_t getChildMask(void) const;
+        void setHasChild(unsigned char index);
     };
 
   public:
-      /**
-       * These values represent the result states of a search in the Dictionary structure (using find(std::string word)).
-       * HIT_TERMINAL = a word has been found, and the final node is a terminal node in the Dictionary.
-       * HIT_PARENT = a word has been found, and the final node is a parent node.
-       * MISS_PARENT = a word has not been found, and the final node is a parent node.
-       * MISS = a word could not be found and somewhere in the search a null node was inspecting - indicating an absence from the Dictionary.
-       */
-      enum SEARCH_STATUS
-      {
-         HIT_TERMINAL,
-         HIT_PARENT,
-         MISS_PARENT,
-         MISS
-      };
 
       /**
        * Default constructor.
        */
-      Dictionary(void);
+      BasicDictionary(void);
       /**
        * Constructor that inserts words from the provided dictionary .txt file.
        * The words added must be in the range: 2 <= {word length} <= maximumWordSize. 
@@ -67,13 +95,36 @@ class Dictionary
        * @param file: the dictionary .txt file to encode
        * @param maximumWordSize: the maximum length of words that will be stored
        */
-      Dictionary(std::ifstream& file, size_t maximumWordSize);
+      BasicDictionary(std::ifstream& file, size_t maximumWordSize);
+      /**
+       * Constructor that inserts words read in place from the provided memory mapped dictionary .txt file.
+       * No string is created per line; each word is validated and inserted straight from the mapped bytes.
+       * Lines may end with "\n" or "\r\n".
+       * The words added must be in the range: 2 <= {word length} <= maximumWordSize.
+       * 
+       * If wheels are provided, the words they cannot form are rejected before any node is created for them,
+       * so the dictionary only serves searches of those wheels.
+       * 
+       * With more than one thread, the file is split into chunks of whole lines that are scanned concurrently, and
+       * each word is routed to the shard of its first letter. Each shard's subtrie is then built by a single thread
+       * and attached under the root. The structure is identical to that of a single threaded build, and an invalid
+       * word is reported as it would be by one: the first in the file.
+       * 
+       * @param file: the mapped dictionary .txt file to encode
+       * @param maximumWordSize: the maximum length of words that will be stored
+       * @param wheels: the wheels the dictionary will be searched with, or nullptr to store every word
+       * @param threads: the number of threads to build with. 0 selects the number of hardware threads.
+       */
+      BasicDictionary(const MappedFile& file, size_t maximumWordSize, const BasicWheels<Alphabet>* wheels = nullptr,
+          size_t threads = 1);
       /**
        * Inserts a new word in the dictionary.
        * 
+       * An exception will be thrown if the word holds a character outside the alphabet.
+       * 
        * @param word: the word to insert in the dictionary.
        */
-      void insert(const std::string& word) const;
+      void insert(std::string_view word) const;
       /**
        * Attempts to find a word in the dictionary.
        * 
@@ -81,8 +132,119 @@ class Dictionary
        * @return the status of the search. See the SEARCH_STATUS enum for more information on the possible return values.
        */
       SEARCH_STATUS find(const std::string& word);
+      /**
+       * Gets the maximum length of the words read from a dictionary file.
+       * Longer words in the file were not stored. A default constructed dictionary has no maximum.
+       * 
+       * @return the maximum length of the words read from a dictionary file
+       */
+      size_t getMaximumWordSize(void) const;
+      /**
+       * Visits the words of a range of a dictionary .txt file that belong in a dictionary, in file order.
+       * Lines may end with "\n" or "\r\n". Only the words 2 <= {word length} <= maximumWordSize are visited,
+       * and if wheels are provided, only those they can form.
+       * 
+       * Each word in range is validated before the wheels are checked, so every builder reports the same first invalid
+       * word of a file, whatever order it goes on to add the words in.
+       * An exception will be thrown if a word holds a character outside the alphabet.
+       * 
+       * @param position: the start of the range, at the beginning of a line
+       * @param end: the end of the range, at the end of a line or of the file
+       * @param maximumWordSize: the maximum length of the words visited
+       * @param wheels: the wheels the dictionary will be searched with, or nullptr to visit every word
+       * @param visit: called with each word, as a view into the range
+       */
+      template <typename Visit>
+      static void forEachWord(const char* position, const char* end, size_t maximumWordSize,
+          const BasicWheels<Alphabet>* wheels, Visit visit)
+      {
+          MappedFile::forEachLine(position, end, [&](std::string_view word)
+          {
+              if(word.length() > 1 && word.length() <= maximumWordSize)
+              {
+                  Alphabets::validateWord<Alphabet>(word);
+
+                  if(wheels == nullptr || wheels->canForm(word))
+                  {
+                      visit(word);
+                  }
+              }
+
+              return true;
+          });
+      }
+
+      /**
+       * A position in the Dictionary that moves one letter at a time.
+       * 
+       * A search that only ever appends or drops the final letter of its current word can hold onto a cursor,
+       * so that each step costs a single child lookup instead of a walk from the root.
+       * The cursor must not outlive the Dictionary it was created from.
+       */
+      class Cursor
+      {
+        public:
+          /**
+           * Constructor. The cursor starts at the root of the dictionary, representing the empty word.
+           * 
+           * @param dictionary: the dictionary to traverse
+           */
+          explicit Cursor(const BasicDictionary& dictionary);
+          /**
+           * Appends a letter to the word represented by the cursor.
+           * Descending by a letter that is not present in the Dictionary is allowed; the cursor reports MISS
+           * until it has ascended back above that letter.
+           * 
+           * @param letter: the letter to append, expected to be a letter of the alphabet in either case
+           * @return the status of the word now represented by the cursor
+           */
+          SEARCH_STATUS descend(char letter);
+          /**
+           * Drops the final letter of the word represented by the cursor.
+           * Has no effect if the cursor is at the root.
+           */
+          void ascend(void);
+          /**
+           * Moves the cursor back to the root, representing the empty word.
+           */
+          void reset(void);
+          /**
+           * Gets the status of the word represented by the cursor, equivalent to calling find() with that word.
+           * 
+           * @return the status of the word represented by the cursor
+           */
+          SEARCH_STATUS status(void) const;
+          /**
+           * Gets the letters that extend the word represented by the cursor to a prefix present in the Dictionary.
+           * 
+           * @return a mask with bit 0 set for the first letter of the alphabet, and so on, or 0 if the word is absent from the Dictionary
+           */
+          uint32_t getChildMask(void) const;
+          /**
+           * Gets the number of letters in the word represented by the cursor.
+           * 
+           * @return the number of letters in the word represented by the cursor
+           */
+          size_t depth(void) const;
+
+        private:
+          // The nodes visited from the root to the current letter. A nullptr marks a letter absent from the Dictionary.
+          std::vector<const Node*> path;
+      };
 
   private:
     // The root node in the dictionary. This is the only node that does not represent a character in a word.
     const std::unique_ptr<Node> root;
+    // The maximum length of the words read from a dictionary file.
+    size_t maximumWordSize = SIZE_MAX;
+
+    // Gets the search status of the word ending at the given node, or MISS if the node is nullptr.
+    static SEARCH_STATUS statusOf(const Node* node);
+    // Inserts the letters of a word under the given node, creating the missing nodes. The letters must be in the alphabet.
+    static void insertUnder(Node* node, std::string_view letters);
+    // Inserts the words of the mapped file, split between a number of threads by their first letter.
+    void insertInParallel(std::string_view contents, const BasicWheels<Alphabet>* wheels, size_t threads);
 };
+
+/// The dictionary of words made of the letters [A-Z].
+using Dictionary = BasicDictionary<LatinAlphabet>;
@@ -0,0 +1,90 @@
+#include "DictionaryHandle.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "FlatDictionary.h"
+
+DictionaryHandle::Snapshot::Snapshot(const DictionaryHandle& handle, Version* version) : handle(&handle), version(version) {}
+
+DictionaryHandle::Snapshot::Snapshot(Snapshot&& other) noexcept : handle(other.handle), version(other.version)
+{
+    other.version = nullptr;
+}
+
+DictionaryHandle::Snapshot::~Snapshot(void)
+{
+    if(version != nullptr)
+    {
+        handle->transitions.fetch_add(1);
+        handle->unpin(version);
+        handle->transitions.fetch_sub(1);
+    }
+}
+
+const FlatDictionary& DictionaryHandle::Snapshot::operator*(void) const
+{
+    return *version->dictionary;
+}
+
+const FlatDictionary* DictionaryHandle::Snapshot::operator->(void) const
+{
+    return version->dictionary.get();
+}
+
+DictionaryHandle::DictionaryHandle(std::unique_ptr<FlatDictionary> dictionary)
+{
+    versions.push_back(std::make_unique<Version>(std::move(dictionary)));
+    current.store(versions.back().get());
+}
+
+DictionaryHandle::Snapshot DictionaryHandle::acquire(void) const
+{
+    // Announced before the current version is read, so its record is not reclaimed while it may be pinned.
+    transitions.fetch_add(1);
+
+    while(true)
+    {
+        Version* version = current.load();
+        version->readers.fetch_add(1);
+
+        // The version was still current once pinned, so the handle's pin was still held and the count cannot reach
+        // 0 before the snapshot is destroyed. Otherwise it was replaced in between, and the new version is tried instead.
+        if(current.load() == version)
+        {
+            transitions.fetch_sub(1);
+            return Snapshot(*this, version);
+        }
+
+        unpin(version);
+    }
+}
+
+void DictionaryHandle::publish(std::unique_ptr<FlatDictionary> dictionary)
+{
+    const std::lock_guard<std::mutex> lock(publishing);
+
+    versions.push_back(std::make_unique<Version>(std::move(dictionary)));
+
+    // The handle's own pin on the replaced version is dropped, so its last snapshot frees it.
+    unpin(current.exchange(versions.back().get()));
+
+    // A freed version is no longer current, so a snapshot acquired from now on never reads it. Once no snapshot
+    // is in transition, none that read it earlier is still touching it either.
+    if(transitions.load() == 0)
+    {
+        std::erase_if(versions, [](const std::unique_ptr<Version>& version) { return version->isReleased.load(); });
+    }
+}
+
+void DictionaryHandle::unpin(Version* version)
+{
+    // A search that read the version just before it was replaced may pin it again after it was freed, and drop the
+    // count to 0 a second time, so only the first to do so frees it.
+    if(version->readers.fetch_sub(1) == 1 && !version->isReleased.exchange(true))
+    {
+        version->dictionary.reset();
+    }
+}
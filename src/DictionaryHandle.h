@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "FlatDictionary.h"
+
+/**
+ * A dictionary that can be replaced while searches are using it, in the style of read-copy-update.
+ *
+ * A search acquires a snapshot of the current dictionary and uses it until the snapshot is destroyed. Publishing a
+ * new dictionary swaps an atomic pointer, so searches started afterwards use the new dictionary while those in flight
+ * keep their snapshot. A replaced dictionary is freed once its last snapshot is destroyed.
+ *
+ * Acquiring and releasing a snapshot take no lock: a pinned count on the version is raised, and the version is
+ * checked to still be current, so a version can never be freed between being read and being pinned.
+ * Only publishers are serialised.
+ *
+ * The record of a replaced version outlives its dictionary, as a search may still be about to pin it. Each publish
+ * reclaims the records of freed versions once no snapshot is being acquired or released, so only the versions
+ * still in use, and those freed since the last publish, are held.
+ */
+class DictionaryHandle
+{
+    // A published dictionary and the snapshots pinning it.
+    struct Version
+    {
+        explicit Version(std::unique_ptr<FlatDictionary> dictionary) : dictionary(std::move(dictionary)) {}
+
+        std::unique_ptr<FlatDictionary> dictionary;
+        // The number of snapshots pinning the version, including those about to find it replaced, plus one held by
+        // the handle while the version is current. Whoever drops the count to 0 frees the dictionary, so the
+        // decision never rests on a count read before the version was replaced.
+        std::atomic<size_t> readers = 1;
+        // True once the dictionary of a replaced version has been freed.
+        std::atomic<bool> isReleased = false;
+    };
+
+  public:
+    /// A dictionary in use by a search. The dictionary is kept alive, unchanged, until the snapshot is destroyed.
+    class Snapshot
+    {
+      public:
+        Snapshot(Snapshot&& other) noexcept;
+        ~Snapshot(void);
+
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+        Snapshot& operator=(Snapshot&&) = delete;
+
+        const FlatDictionary& operator*(void) const;
+        const FlatDictionary* operator->(void) const;
+
+      private:
+        friend class DictionaryHandle;
+
+        Snapshot(const DictionaryHandle& handle, Version* version);
+
+        const DictionaryHandle* handle;
+        Version* version;
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param dictionary: the first dictionary to publish
+     */
+    explicit DictionaryHandle(std::unique_ptr<FlatDictionary> dictionary);
+
+    DictionaryHandle(const DictionaryHandle&) = delete;
+    DictionaryHandle& operator=(const DictionaryHandle&) = delete;
+
+    /**
+     * Gets a snapshot of the current dictionary. Never blocks, and may be called from any thread.
+     * The handle must outlive the snapshot.
+     *
+     * @return a snapshot of the most recently published dictionary
+     */
+    Snapshot acquire(void) const;
+    /**
+     * Replaces the current dictionary. Snapshots already acquired keep the replaced dictionary, which is freed
+     * once the last of them is destroyed.
+     *
+     * @param dictionary: the dictionary to publish
+     */
+    void publish(std::unique_ptr<FlatDictionary> dictionary);
+
+  private:
+    std::atomic<Version*> current;
+    // The number of snapshots being acquired or released, which may be touching the record of a replaced version.
+    mutable std::atomic<size_t> transitions = 0;
+    // Every version published and not yet reclaimed, the current one last.
+    std::vector<std::unique_ptr<Version>> versions;
+    // Serialises publishers.
+    std::mutex publishing;
+
+    // Drops a pin on a version, freeing its dictionary if it was the last pin of a replaced version.
+    static void unpin(Version* version);
+};
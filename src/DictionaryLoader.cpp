@@ -0,0 +1,79 @@
+#include "DictionaryLoader.h"
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <filesystem>
+#include <stdexcept>
+
+#include "Dictionary.h"
+#include "FlatDictionary.h"
+#include "DawgBuilder.h"
+#include "MappedFile.h"
+#include "Wheels.h"
+#include "Utils.h"
+
+std::unique_ptr<FlatDictionary> DictionaryLoader::load(const Utils::Options& options, size_t maximumWordSize,
+    const Wheels* wheels)
+{
+    if(!options.indexPath.empty() && std::filesystem::exists(options.indexPath))
+    {
+        try
+        {
+            auto image = std::make_unique<FlatDictionary>(FlatDictionary::load(options.indexPath));
+            const FlatDictionary::LAYOUT layout = options.dawg ? FlatDictionary::DAWG : FlatDictionary::TRIE;
+
+            // Words the wheels can form may have been left out of an image built for shorter words.
+            if(image->getMaximumWordSize() >= maximumWordSize && image->getLayout() == layout)
+            {
+                return image;
+            }
+
+            if(image->getLayout() != layout)
+            {
+                std::cerr << "The dictionary image " << options.indexPath << " is laid out as a "
+                    << (layout == FlatDictionary::DAWG ? "trie" : "DAWG") << ". Rebuilding it." << std::endl;
+            }
+            else
+            {
+                std::cerr << "The dictionary image " << options.indexPath << " holds words of up to " << image->getMaximumWordSize()
+                    << " letters, but the wheels can form words of " << maximumWordSize << " letters. Rebuilding it." << std::endl;
+            }
+        }
+        catch(const std::invalid_argument& e)
+        {
+            std::cerr << e.what() << " Rebuilding the dictionary image " << options.indexPath << "." << std::endl;
+        }
+    }
+
+    std::unique_ptr<FlatDictionary> dictionary;
+    // Only a dictionary that is not written to an image may leave out the words of other puzzles.
+    const Wheels* pruningWheels = options.indexPath.empty() && options.buildIndexPath.empty() ? wheels : nullptr;
+
+    if(options.dawg)
+    {
+        // The automaton is minimized as it is built, so the full trie is never held in memory.
+        const MappedFile mappedDictionary(options.dictionaryPath);
+
+        dictionary = std::make_unique<FlatDictionary>(DawgBuilder::build(mappedDictionary, maximumWordSize, pruningWheels));
+    }
+    else
+    {
+        // Reads the words in place from the mapped file, sharded by first letter over the search's threads, then
+        // compiles the trie into its compact, contiguous form for the search. The original nodes are released at the end of this scope.
+        const MappedFile mappedDictionary(options.dictionaryPath);
+        const Dictionary trie(mappedDictionary, maximumWordSize, pruningWheels, options.threads);
+
+        dictionary = std::make_unique<FlatDictionary>(trie);
+    }
+
+    for(const std::string& path : { options.indexPath, options.buildIndexPath })
+    {
+        if(!path.empty())
+        {
+            dictionary->save(path);
+        }
+    }
+
+    return dictionary;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <memory>
+#include <cstddef>
+
+#include "FlatDictionary.h"
+#include "Wheels.h"
+#include "Utils.h"
+
+/// Provides the dictionary used by a search, from a prebuilt image or from the dictionary .txt file.
+class DictionaryLoader
+{
+  public:
+    /**
+     * Loads the dictionary used by the search.
+     * 
+     * The dictionary image provided with --index is mapped and queried in place, as long as it was built with words
+     * long enough for the wheels. Otherwise the dictionary is built from its .txt file, compiled into its flat form,
+     * and written as an image to the paths provided with --index and --build-index.
+     * 
+     * If the wheels of a single puzzle are provided and no image is involved, the words the wheels cannot form
+     * are left out as the dictionary is built, which shrinks it and its build time for a small puzzle. An image is
+     * reused by other puzzles, so it always holds every word.
+     * 
+     * An exception will be thrown if the dictionary cannot be read or built, or an image cannot be written.
+     * 
+     * @param options: the options read from the CLI arguments
+     * @param maximumWordSize: the length of the longest word the wheels can form
+     * @param wheels: the wheels the dictionary will be searched with, or nullptr if it serves many puzzles
+     * @return the dictionary used by the search
+     */
+    static std::unique_ptr<FlatDictionary> load(const Utils::Options& options, size_t maximumWordSize,
+        const Wheels* wheels = nullptr);
+};
@@ -2,22 +2,114 @@
 #include <string>
 #include <fstream>
 #include <exception>
+#include <stdexcept>
+#include <string_view>
 #include <memory>
-#include <unordered_set>
+#include <cstdint>
+#include <chrono>
 
 #include "Wheels.h"
 #include "Dictionary.h"
+#include "FlatDictionary.h"
 #include "Utils.h"
+#include "DictionaryLoader.h"
+#include "DictionaryHandle.h"
+#include "Search.h"
+#include "WordSet.h"
+#include "Batch.h"
+#include "Server.h"
+#include "Stats.h"
+#include "Streaming.h"
+#include "IncrementalSolver.h"
+#include "ResultWriter.h"
+
+namespace
+{
+    /**
+     * Measures the wall time elapsed since the given point.
+     * 
+     * @param start: the point the phase started at
+     * @return the elapsed time in seconds
+     */
+    double secondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /**
+     * Writes the statistics report to the error stream, if it was requested, so the words written to the console are unchanged.
+     * 
+     * @param stats: the statistics gathered, completed with those of the dictionary
+     * @param dictionary: the dictionary searched
+     * @param options: the user options
+     */
+    void writeStats(Stats& stats, const FlatDictionary& dictionary, const Utils::Options& options)
+    {
+        if(!options.stats)
+        {
+            return;
+        }
+
+        stats.dictionaryNodes = dictionary.getNodeCount();
+        stats.dictionaryBytes = dictionary.getSizeInBytes();
+        stats.dictionaryLayout = dictionary.getLayout() == FlatDictionary::DAWG ? "dawg" : "trie";
+        stats.write(options.statsFormat, std::cerr);
+    }
+}
 
 int main(int argc, char* argv[])
 {
+    Utils::Options options;
     std::ifstream wheelsFile;
     std::ifstream dictionaryFile;
 
+    try
+    {
+        // Reads the options from CLI arguments.
+        options = Utils::parseOptions(argc, argv);
+    }
+    catch (const std::invalid_argument& e)
+    {
+        std::cerr << e.what();
+        return -1;
+    }
+
+    // Solves every puzzle listed in the batch file against one dictionary.
+    if(!options.batchPath.empty())
+    {
+        try
+        {
+            return Batch::solve(options) == 0 ? 0 : -1;
+        }
+        catch(const std::exception& e)
+        {
+            std::cerr << e.what() << std::endl;
+            return -1;
+        }
+    }
+
+    // Answers puzzles sent over a local socket against one dictionary, holding every word as the puzzles are not yet known.
+    if(!options.serveAddress.empty())
+    {
+        try
+        {
+            DictionaryHandle dictionary(DictionaryLoader::load(options, SIZE_MAX));
+            Server server(dictionary, options.serveAddress, options);
+
+            server.run();
+        }
+        catch(const std::exception& e)
+        {
+            std::cerr << e.what() << std::endl;
+        }
+
+        return -1;
+    }
+
     try
     {
         // Attempts to open files from CLI arguments.
-        Utils::initFiles(argc, argv, wheelsFile, dictionaryFile);
+        Utils::initFiles(options, wheelsFile, dictionaryFile);
     }
     catch (const std::invalid_argument& e)
     {
@@ -25,15 +117,52 @@ int main(int argc, char* argv[])
         return -1;
     }
 
-    std::unique_ptr<Dictionary> dictionary;
+    std::unique_ptr<FlatDictionary> dictionary;
     std::unique_ptr<Wheels> letteredWheels;
+    Stats stats;
+
+    // Searches the wheels as they are read, so only the dictionary and a window of wheels are held in memory.
+    if(options.stream)
+    {
+        try
+        {
+            auto start = std::chrono::steady_clock::now();
+            // The wheels are not counted up front, so every word is loaded.
+            dictionary = DictionaryLoader::load(options, SIZE_MAX);
+            stats.dictionaryBuildSeconds = secondsSince(start);
+
+            start = std::chrono::steady_clock::now();
+            stats.wordsFound = Streaming::solve(wheelsFile, *dictionary, options, std::cout,
+                options.stats ? &stats.counters : nullptr);
+            stats.searchSeconds = secondsSince(start);
+        }
+        catch(const std::exception& e)
+        {
+            std::cerr << e.what() << std::endl;
+            return -1;
+        }
+
+        Utils::closeFiles(wheelsFile, dictionaryFile);
+
+        // Reading the wheels and writing the words are interleaved with the search, so both are timed with it.
+        writeStats(stats, *dictionary, options);
+
+        return 0;
+    }
 
     try
     {
+        auto start = std::chrono::steady_clock::now();
         // Initialises the lettered wheels.
         letteredWheels = std::make_unique<Wheels>(wheelsFile);
-        // Initialises the dictionary, encoded as a trie structure.
-        dictionary = std::make_unique<Dictionary>(dictionaryFile, letteredWheels->getNumberOfWheels());
+        stats.wheelParseSeconds = secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        // Initialises the dictionary, encoded as a flat trie structure. Replaced wheels may form words the
+        // original wheels cannot, so an interactive dictionary keeps them.
+        dictionary = DictionaryLoader::load(options, letteredWheels->getNumberOfWheels(),
+            options.interactive ? nullptr : letteredWheels.get());
+        stats.dictionaryBuildSeconds = secondsSince(start);
     }
     catch(const std::invalid_argument& e)
     {
@@ -45,28 +174,109 @@ int main(int argc, char* argv[])
         std::cerr << e.what() << std::endl;
         return -1;
     }
+    catch(const std::runtime_error& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
 
     Utils::closeFiles(wheelsFile, dictionaryFile);
 
-    // The collection of unique words generated from the lettered wheels, and found in the dictionary.
-    std::unordered_set<std::string> result;
-    // The current word to attempt to find in the dictionary.
-    std::string permutation = letteredWheels->getCurrentPermutation();
+    // Solves the wheels, then applies each "WHEEL LETTERS" replacement read from the console as it arrives.
+    if(options.interactive)
+    {
+        IncrementalSolver solver(*letteredWheels, *dictionary);
+        Utils::printResult(solver.getResult(), options);
 
-    while(letteredWheels->canPermute())
+        std::string line;
+
+        while(std::getline(std::cin, line))
+        {
+            const size_t separator = line.find(' ');
+            IncrementalSolver::Change change;
+
+            try
+            {
+                const std::string index = line.substr(0, separator);
+
+                if(separator == std::string::npos || index.empty() || index.find_first_not_of("0123456789") != std::string::npos)
+                {
+                    throw std::invalid_argument("A replacement must be a wheel index and its letters. Value: " + line);
+                }
+
+                change = solver.replaceWheel(std::stoull(index), std::string_view(line).substr(separator + 1));
+            }
+            catch(const std::logic_error& e)
+            {
+                std::cerr << e.what() << std::endl;
+                continue;
+            }
+
+            // The words added and removed are written with the new count, and handed to the console at once.
+            ResultWriter writer(std::cout);
+            std::string word;
+
+            if(!options.countOnly)
+            {
+                for(FlatDictionary::WordId id : change.removed)
+                {
+                    dictionary->getWord(id, word);
+                    writer.appendEdit(word, false, options.format);
+                }
+
+                for(FlatDictionary::WordId id : change.added)
+                {
+                    dictionary->getWord(id, word);
+                    writer.appendEdit(word, true, options.format);
+                }
+            }
+
+            writer.appendCount(solver.getResult().size(), options.format);
+        }
+
+        return 0;
+    }
+
+    // Pulls words from the lazy search only until the first N are found, so the rest of the traversal never runs.
+    if(options.firstCount > 0)
     {
-        // Attempts a search for the current word, permutation, in the dictionary.
-        Dictionary::SEARCH_STATUS state = dictionary->find(permutation);
-        
-        // The word has been found, so add it to the result set.
-        if(state == Dictionary::HIT_PARENT || state == Dictionary::HIT_TERMINAL)
+        const auto start = std::chrono::steady_clock::now();
+        ResultWriter writer(std::cout);
+
+        for(std::string_view word : Search::generate(*letteredWheels, *dictionary, options.memoize,
+            options.stats ? &stats.counters : nullptr))
         {
-            result.insert(permutation);
+            if(!options.countOnly)
+            {
+                writer.appendWord(word, options.format);
+            }
+
+            if(++stats.wordsFound == options.firstCount)
+            {
+                break;
+            }
         }
 
-        // Generate a new word to attempt to find.
-        permutation = letteredWheels->advancePermutation(state);
+        writer.appendCount(stats.wordsFound, options.format);
+        writer.flush();
+        // Writing the words is interleaved with the search, so both are timed with it.
+        stats.searchSeconds = secondsSince(start);
+
+        writeStats(stats, *dictionary, options);
+
+        return 0;
     }
 
-    Utils::printResult(result);
+    auto start = std::chrono::steady_clock::now();
+    // The collection of unique words generated from the lettered wheels, and found in the dictionary.
+    const WordSet result = Search::solve(*letteredWheels, *dictionary, options, options.threads,
+        options.stats ? &stats.counters : nullptr);
+    stats.searchSeconds = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    Utils::printResult(result, options);
+    stats.outputSeconds = secondsSince(start);
+
+    stats.wordsFound = result.size();
+    writeStats(stats, *dictionary, options);
 }
\ No newline at end of file
@@ -0,0 +1,638 @@
+#include "FlatDictionary.h"
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <bit>
+#include <stdexcept>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+#include "Dictionary.h"
+#include "Utils.h"
+#include "Alphabet.h"
+
+namespace
+{
+    // Marks a node whose longest continuation is not yet measured.
+    constexpr uint32_t UNMEASURED = UINT32_MAX;
+
+    /**
+     * Measures the longest continuation of the prefix at a node. Nodes shared by a DAWG are measured once.
+     *
+     * @param dictionary: the dictionary being measured
+     * @param node: the node of the prefix
+     * @param lengths: the measured length of each node, or UNMEASURED
+     * @return the number of letters in the longest continuation
+     */
+    uint32_t measure(const FlatDictionary& dictionary, FlatDictionary::NodeId node, std::vector<uint32_t>& lengths)
+    {
+        if(lengths[node] != UNMEASURED)
+        {
+            return lengths[node];
+        }
+
+        uint32_t longest = 0;
+
+        for(uint32_t letters = dictionary.getChildMask(node); letters != 0; letters &= letters - 1)
+        {
+            const unsigned char letter = static_cast<unsigned char>(std::countr_zero(letters));
+
+            longest = std::max(longest, 1 + measure(dictionary, dictionary.getChild(node, letter), lengths));
+        }
+
+        lengths[node] = longest;
+
+        return longest;
+    }
+}
+
+FlatDictionary::FlatDictionary(const Dictionary& dictionary) : maximumWordSize(dictionary.getMaximumWordSize())
+{
+    // Nodes are numbered in breadth-first order, so every node is numbered before its children are visited
+    // and the children of a node occupy consecutive edges.
+    std::queue<const Dictionary::Node*> pending;
+
+    pending.push(dictionary.root.get());
+    ownedNodes.emplace_back();
+    ownedParents.push_back(NO_NODE);
+    ownedLetters.push_back(0);
+
+    for(uint32_t index = 0; !pending.empty(); index++)
+    {
+        const Dictionary::Node* source = pending.front();
+        pending.pop();
+
+        Node& node = ownedNodes[index];
+        node.firstEdge = static_cast<uint32_t>(ownedEdges.size());
+
+        if(source->getIsWord())
+        {
+            node.mask |= WORD_FLAG;
+        }
+
+        for(unsigned char c = 0; c < Utils::LETTERS_IN_ALPHABET; c++)
+        {
+            const Dictionary::Node* sourceChild = source->getChild(c);
+
+            if(sourceChild != nullptr)
+            {
+                // The 32-bit indices leave NO_NODE free as a sentinel.
+                if(ownedNodes.size() >= NO_NODE)
+                {
+                    throw std::length_error("The dictionary has too many nodes to be stored in a flat structure.");
+                }
+
+                ownedNodes[index].mask |= 1u << c;
+                ownedEdges.push_back(static_cast<uint32_t>(ownedNodes.size()));
+                ownedNodes.emplace_back();
+                ownedParents.push_back(index);
+                ownedLetters.push_back(c);
+                pending.push(sourceChild);
+            }
+        }
+    }
+
+    ownedNodes.shrink_to_fit();
+    ownedEdges.shrink_to_fit();
+    ownedParents.shrink_to_fit();
+    ownedLetters.shrink_to_fit();
+
+    // Every child is numbered after its parent, so measuring in reverse order measures every child first.
+    ownedHeights.assign(ownedNodes.size(), 0);
+
+    for(size_t index = ownedNodes.size(); index-- > 0;)
+    {
+        measureHeight(static_cast<uint32_t>(index));
+    }
+
+    nodes = ownedNodes.data();
+    nodeCount = ownedNodes.size();
+    edges = ownedEdges.data();
+    edgeCount = ownedEdges.size();
+    parents = ownedParents.data();
+    letters = ownedLetters.data();
+    heights = ownedHeights.data();
+    wordIdCount = nodeCount;
+}
+
+FlatDictionary::FlatDictionary(std::vector<Node> dawgNodes, std::vector<uint32_t> dawgEdges, const size_t maximumWordSize) :
+    ownedNodes(std::move(dawgNodes)), ownedEdges(std::move(dawgEdges)), maximumWordSize(maximumWordSize)
+{
+    // The number of words below every node, counting the node's own word.
+    std::vector<uint64_t> wordCounts(ownedNodes.size(), 0);
+    ownedEdgeRanks.assign(ownedEdges.size(), 0);
+    ownedHeights.assign(ownedNodes.size(), 0);
+
+    const auto countWords = [&](uint32_t index)
+    {
+        const Node& node = ownedNodes[index];
+        uint64_t count = (node.mask & WORD_FLAG) ? 1 : 0;
+
+        // The words through an edge sort after the node's own word and those of every lower letter.
+        for(uint32_t edge = node.firstEdge; edge < node.firstEdge + std::popcount(node.mask & LETTER_MASK); edge++)
+        {
+            if(count >= NO_NODE)
+            {
+                throw std::length_error("The dictionary has too many words to be numbered in a flat structure.");
+            }
+
+            ownedEdgeRanks[edge] = static_cast<uint32_t>(count);
+            count += wordCounts[ownedEdges[edge]];
+        }
+
+        wordCounts[index] = count;
+        measureHeight(index);
+    };
+
+    // Every child precedes its parent, so counting in index order counts every child first. The root comes last.
+    for(uint32_t index = 1; index < ownedNodes.size(); index++)
+    {
+        countWords(index);
+    }
+
+    countWords(ROOT);
+
+    nodes = ownedNodes.data();
+    nodeCount = ownedNodes.size();
+    edges = ownedEdges.data();
+    edgeCount = ownedEdges.size();
+    edgeRanks = ownedEdgeRanks.data();
+    heights = ownedHeights.data();
+    layout = DAWG;
+    wordIdCount = static_cast<size_t>(wordCounts[ROOT]);
+}
+
+FlatDictionary::FlatDictionary(std::unique_ptr<MappedFile> mappedImage) : image(std::move(mappedImage))
+{
+    const std::string_view contents = image->getContents();
+    ImageHeader header;
+
+    if(contents.size() < sizeof(header))
+    {
+        throw std::invalid_argument("The file is too small to be a dictionary image.");
+    }
+
+    std::memcpy(&header, contents.data(), sizeof(header));
+
+    if(std::memcmp(header.magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC)) != 0)
+    {
+        throw std::invalid_argument("The file is not a dictionary image.");
+    }
+
+    if(header.version != IMAGE_VERSION || header.byteOrder != 1 || (header.layout != TRIE && header.layout != DAWG))
+    {
+        throw std::invalid_argument("The dictionary image was written by an incompatible version or machine.");
+    }
+
+    // A trie records a parent and a letter per node, and a DAWG a rank per edge.
+    const uint64_t linkBytes = header.layout == TRIE
+        ? header.nodeCount * (sizeof(uint32_t) + 1) : header.edgeCount * sizeof(uint32_t);
+
+    // The arrays must exactly fill the remainder of the file, and contain at least the root.
+    if(header.nodeCount == 0 || header.nodeCount >= NO_NODE || header.edgeCount >= NO_NODE || header.wordIdCount >= NO_NODE
+        || contents.size() != sizeof(header) + header.nodeCount * sizeof(Node) + header.edgeCount * sizeof(uint32_t) + linkBytes
+            + header.nodeCount)
+    {
+        throw std::invalid_argument("The dictionary image is truncated or corrupt.");
+    }
+
+    // The mapping is page aligned, and the header size keeps both arrays aligned after it.
+    nodes = reinterpret_cast<const Node*>(contents.data() + sizeof(header));
+    nodeCount = static_cast<size_t>(header.nodeCount);
+    edges = reinterpret_cast<const uint32_t*>(nodes + nodeCount);
+    edgeCount = static_cast<size_t>(header.edgeCount);
+    layout = static_cast<LAYOUT>(header.layout);
+    wordIdCount = static_cast<size_t>(header.wordIdCount);
+
+    if(layout == TRIE)
+    {
+        parents = edges + edgeCount;
+        letters = reinterpret_cast<const unsigned char*>(parents + nodeCount);
+        heights = letters + nodeCount;
+    }
+    else
+    {
+        edgeRanks = edges + edgeCount;
+        heights = reinterpret_cast<const unsigned char*>(edgeRanks + edgeCount);
+    }
+
+    maximumWordSize = header.maximumWordSize > SIZE_MAX ? SIZE_MAX : static_cast<size_t>(header.maximumWordSize);
+
+    validate();
+}
+
+void FlatDictionary::validate(void) const
+{
+    const std::invalid_argument corrupt("The dictionary image is truncated or corrupt.");
+    // In a DAWG, the number of words below every node, counting the node's own word.
+    std::vector<uint64_t> wordCounts(layout == DAWG ? nodeCount : 0, 0);
+
+    if(layout == TRIE && (parents[ROOT] != NO_NODE || wordIdCount != nodeCount))
+    {
+        throw corrupt;
+    }
+
+    // A DAWG lists every child before its parent, the root aside, so its children are checked before it.
+    for(size_t step = 0; step < nodeCount; step++)
+    {
+        const uint32_t index = static_cast<uint32_t>(layout == DAWG ? (step + 1) % nodeCount : step);
+        const Node& node = nodes[index];
+        const uint32_t childLetters = node.mask & LETTER_MASK;
+        const uint32_t childCount = static_cast<uint32_t>(std::popcount(childLetters));
+        uint64_t count = (node.mask & WORD_FLAG) ? 1 : 0;
+        unsigned height = 0;
+
+        if((node.mask & ~(LETTER_MASK | WORD_FLAG)) != 0 || uint64_t(node.firstEdge) + childCount > edgeCount)
+        {
+            throw corrupt;
+        }
+
+        // A trie numbers every child after its parent, and records the parent and letter leading to it,
+        // so spelling a word walks back to the root.
+        if(layout == TRIE && index != ROOT && (parents[index] >= index || letters[index] >= Utils::LETTERS_IN_ALPHABET))
+        {
+            throw corrupt;
+        }
+
+        uint32_t remaining = childLetters;
+
+        for(uint32_t edge = node.firstEdge; edge < node.firstEdge + childCount; edge++, remaining &= remaining - 1)
+        {
+            const uint32_t child = edges[edge];
+
+            if(child >= nodeCount || child == ROOT)
+            {
+                throw corrupt;
+            }
+
+            if(layout == TRIE)
+            {
+                if(child <= index || parents[child] != index || letters[child] != std::countr_zero(remaining))
+                {
+                    throw corrupt;
+                }
+            }
+            else
+            {
+                // Children precede their parent, so the graph has no cycle, and ranks match the words below each edge.
+                if((index != ROOT && child >= index) || edgeRanks[edge] != count)
+                {
+                    throw corrupt;
+                }
+
+                count += wordCounts[child];
+            }
+
+            height = std::max<unsigned>(height, heights[child] + 1u);
+        }
+
+        if(heights[index] != std::min<unsigned>(height, MAXIMUM_RECORDED_HEIGHT))
+        {
+            throw corrupt;
+        }
+
+        // Every DAWG node leads to a word, so spelling a word by its rank always ends at one.
+        if(layout == DAWG)
+        {
+            if((count == 0 && index != ROOT) || count >= NO_NODE)
+            {
+                throw corrupt;
+            }
+
+            wordCounts[index] = count;
+        }
+    }
+
+    if(layout == DAWG && wordCounts[ROOT] != wordIdCount)
+    {
+        throw corrupt;
+    }
+}
+
+FlatDictionary FlatDictionary::load(const std::string& path)
+{
+    return FlatDictionary(std::make_unique<MappedFile>(path, MappedFile::RANDOM));
+}
+
+void FlatDictionary::save(const std::string& path) const
+{
+    ImageHeader header = {};
+
+    std::memcpy(header.magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC));
+    header.version = IMAGE_VERSION;
+    header.byteOrder = 1;
+    header.maximumWordSize = maximumWordSize;
+    header.nodeCount = nodeCount;
+    header.edgeCount = edgeCount;
+    header.layout = layout;
+    header.wordIdCount = wordIdCount;
+
+    const std::string temporaryPath = path + ".tmp";
+
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(nodes), nodeCount * sizeof(Node));
+        file.write(reinterpret_cast<const char*>(edges), edgeCount * sizeof(uint32_t));
+
+        if(layout == TRIE)
+        {
+            file.write(reinterpret_cast<const char*>(parents), nodeCount * sizeof(uint32_t));
+            file.write(reinterpret_cast<const char*>(letters), nodeCount);
+        }
+        else
+        {
+            file.write(reinterpret_cast<const char*>(edgeRanks), edgeCount * sizeof(uint32_t));
+        }
+
+        file.write(reinterpret_cast<const char*>(heights), nodeCount);
+
+        file.close();
+
+        if(file.fail())
+        {
+            std::filesystem::remove(temporaryPath);
+            throw std::runtime_error("Unable to write the dictionary image with path : " + path);
+        }
+    }
+
+    std::filesystem::rename(temporaryPath, path);
+}
+
+Dictionary::SEARCH_STATUS FlatDictionary::find(const std::string& word) const
+{
+    uint32_t node = ROOT;
+
+    // Iterate through each letter in the word, stopping at the first letter absent from the structure.
+    // A character outside the alphabet maps to an index without a child, so the word is a MISS.
+    for(size_t i = 0; i < word.length() && node != NO_NODE; i++)
+    {
+        node = getChild(node, LatinAlphabet::INDEX[static_cast<unsigned char>(word[i])]);
+    }
+
+    return getStatus(node);
+}
+
+size_t FlatDictionary::getNodeCount(void) const
+{
+    return nodeCount;
+}
+
+size_t FlatDictionary::getSizeInBytes(void) const
+{
+    const size_t linkBytes = layout == TRIE ? nodeCount * (sizeof(uint32_t) + 1) : edgeCount * sizeof(uint32_t);
+
+    return nodeCount * sizeof(Node) + edgeCount * sizeof(uint32_t) + linkBytes + nodeCount;
+}
+
+size_t FlatDictionary::getMaximumWordSize(void) const
+{
+    return maximumWordSize;
+}
+
+size_t FlatDictionary::getLongestWordSize(void) const
+{
+    if(heights[ROOT] < MAXIMUM_RECORDED_HEIGHT)
+    {
+        return heights[ROOT];
+    }
+
+    // The longest word is too long to be recorded, so it is measured.
+    std::vector<uint32_t> lengths(nodeCount, UNMEASURED);
+
+    return measure(*this, ROOT, lengths);
+}
+
+FlatDictionary::NodeId FlatDictionary::getChild(NodeId node, unsigned char letter) const
+{
+    const uint32_t edge = getEdge(node, letter);
+
+    return edge == NO_NODE ? NO_NODE : edges[edge];
+}
+
+FlatDictionary::NodeId FlatDictionary::getChild(NodeId node, unsigned char letter, WordId& id) const
+{
+    const uint32_t edge = getEdge(node, letter);
+
+    if(edge == NO_NODE)
+    {
+        return NO_NODE;
+    }
+
+    // A trie node identifies its prefix, while a DAWG prefix is ranked among the words below the root.
+    id = layout == TRIE ? edges[edge] : id + edgeRanks[edge];
+
+    return edges[edge];
+}
+
+uint32_t FlatDictionary::getEdge(NodeId node, unsigned char letter) const
+{
+    if(letter >= Utils::LETTERS_IN_ALPHABET)
+    {
+        return NO_NODE;
+    }
+
+    const uint32_t mask = nodes[node].mask;
+    const uint32_t bit = 1u << letter;
+
+    if(!(mask & bit))
+    {
+        return NO_NODE;
+    }
+
+    // The rank of the letter among the node's children is its offset from the node's first edge.
+    return nodes[node].firstEdge + std::popcount(mask & (bit - 1));
+}
+
+uint32_t FlatDictionary::getChildMask(NodeId node) const
+{
+    return nodes[node].mask & LETTER_MASK;
+}
+
+bool FlatDictionary::getIsWord(NodeId node) const
+{
+    return (nodes[node].mask & WORD_FLAG) != 0;
+}
+
+Dictionary::SEARCH_STATUS FlatDictionary::getStatus(NodeId node) const
+{
+    // A letter in the word was absent from the structure.
+    if(node == NO_NODE)
+    {
+        return Dictionary::MISS;
+    }
+
+    const uint32_t mask = nodes[node].mask;
+
+    // Node is terminal node - it does not have any children and it is a word.
+    if(!(mask & LETTER_MASK))
+    {
+        return Dictionary::HIT_TERMINAL;
+    }
+
+    return (mask & WORD_FLAG) ? Dictionary::HIT_PARENT : Dictionary::MISS_PARENT;
+}
+
+size_t FlatDictionary::getHeight(NodeId node) const
+{
+    return heights[node] == MAXIMUM_RECORDED_HEIGHT ? UNBOUNDED_HEIGHT : heights[node];
+}
+
+FlatDictionary::LAYOUT FlatDictionary::getLayout(void) const
+{
+    return layout;
+}
+
+size_t FlatDictionary::getWordIdCount(void) const
+{
+    return wordIdCount;
+}
+
+FlatDictionary::NodeId FlatDictionary::getParent(NodeId node) const
+{
+    return parents == nullptr ? NO_NODE : parents[node];
+}
+
+std::string FlatDictionary::getWord(WordId id) const
+{
+    std::string word;
+    getWord(id, word);
+
+    return word;
+}
+
+void FlatDictionary::getWord(WordId id, std::string& word) const
+{
+    if(layout == DAWG)
+    {
+        word.clear();
+
+        // Descends through the edge ranking the word, the last whose rank does not exceed the word's,
+        // until the word is the node's own.
+        for(NodeId node = ROOT; !((nodes[node].mask & WORD_FLAG) && id == 0);)
+        {
+            uint32_t childLetters = nodes[node].mask & LETTER_MASK;
+            uint32_t edge = nodes[node].firstEdge;
+
+            for(uint32_t next = edge + 1; next < nodes[node].firstEdge + std::popcount(childLetters); next++)
+            {
+                if(edgeRanks[next] > id)
+                {
+                    break;
+                }
+
+                edge = next;
+            }
+
+            // The edge's offset from the first edge is the rank of its letter within the node's mask.
+            for(uint32_t rank = edge - nodes[node].firstEdge; rank > 0; rank--)
+            {
+                childLetters &= childLetters - 1;
+            }
+
+            word.push_back(LatinAlphabet::LETTERS[std::countr_zero(childLetters)]);
+            id -= edgeRanks[edge];
+            node = edges[edge];
+        }
+
+        return;
+    }
+
+    NodeId node = id;
+    size_t length = 0;
+
+    for(NodeId ancestor = node; parents[ancestor] != NO_NODE; ancestor = parents[ancestor])
+    {
+        length++;
+    }
+
+    // Fills the letters from the node up to the root, so the word is spelled from its final letter.
+    word.resize(length);
+
+    for(; length > 0; node = parents[node])
+    {
+        word[--length] = LatinAlphabet::LETTERS[letters[node]];
+    }
+}
+
+void FlatDictionary::measureHeight(uint32_t index)
+{
+    const Node& node = ownedNodes[index];
+    unsigned height = 0;
+
+    for(uint32_t edge = node.firstEdge; edge < node.firstEdge + std::popcount(node.mask & LETTER_MASK); edge++)
+    {
+        height = std::max<unsigned>(height, ownedHeights[ownedEdges[edge]] + 1u);
+    }
+
+    ownedHeights[index] = static_cast<unsigned char>(std::min<unsigned>(height, MAXIMUM_RECORDED_HEIGHT));
+}
+
+FlatDictionary::Cursor::Cursor(const FlatDictionary& dictionary) : dictionary(dictionary)
+{
+    path.push_back(ROOT);
+    ids.push_back(0);
+}
+
+Dictionary::SEARCH_STATUS FlatDictionary::Cursor::descend(char letter)
+{
+    uint32_t node = path.back();
+    WordId id = ids.back();
+
+    // Once a letter is missing, every longer word is missing too.
+    if(node != NO_NODE)
+    {
+        node = dictionary.getChild(node, LatinAlphabet::INDEX[static_cast<unsigned char>(letter)], id);
+    }
+
+    path.push_back(node);
+    ids.push_back(id);
+
+    return dictionary.getStatus(node);
+}
+
+void FlatDictionary::Cursor::ascend(void)
+{
+    // The root is never removed.
+    if(path.size() > 1)
+    {
+        path.pop_back();
+        ids.pop_back();
+    }
+}
+
+void FlatDictionary::Cursor::reset(void)
+{
+    path.resize(1);
+    ids.resize(1);
+}
+
+Dictionary::SEARCH_STATUS FlatDictionary::Cursor::status(void) const
+{
+    return dictionary.getStatus(path.back());
+}
+
+uint32_t FlatDictionary::Cursor::getChildMask(void) const
+{
+    return path.back() == NO_NODE ? 0 : dictionary.getChildMask(path.back());
+}
+
+FlatDictionary::NodeId FlatDictionary::Cursor::getNode(void) const
+{
+    return path.back();
+}
+
+FlatDictionary::WordId FlatDictionary::Cursor::getWordId(void) const
+{
+    return ids.back();
+}
+
+size_t FlatDictionary::Cursor::depth(void) const
+{
+    return path.size() - 1;
+}
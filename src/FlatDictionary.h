@@ -0,0 +1,366 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <memory>
+
+#include "Dictionary.h"
+#include "MappedFile.h"
+
+/**
+ * A read-only, compact form of a Dictionary that stores every node in one contiguous array.
+ * 
+ * Each node is a 26-bit child mask plus the offset of its first outgoing edge. The children of a node are stored
+ * consecutively in the edge array, ordered by letter, so the child for a letter is found by ranking the letter
+ * within the mask with a popcount. A node is 8 bytes and each edge 4 bytes, instead of the 26 pointers and
+ * separate heap allocation of a Dictionary node.
+ * 
+ * Searches answer the same SEARCH_STATUS values as the Dictionary the structure was compiled from.
+ * 
+ * Because the structure holds no pointers, it can be saved as a binary image and later memory mapped and
+ * queried in place, without being rebuilt or deserialized. An image starts with a versioned header recording
+ * the maximum word size it was built with, followed by the node, edge, parent and letter arrays in native byte order.
+ * 
+ * The structure is laid out either as a trie, compiled from a Dictionary, or as a DAWG (a minimized acyclic automaton,
+ * or DAFSA) built by DawgBuilder, in which words also share the nodes of their common suffixes. Both layouts
+ * answer every query the same way; a DAWG of a large lexicon holds a fraction of the nodes of its trie.
+ * 
+ * Each word is identified by a dense WordId, so a search may collect ids and only build the strings of the words
+ * it found when they are output. In a trie the id of a word is the node it ends at, and every node records its
+ * parent and the letter leading to it, so a word is spelled by walking back to the root. A DAWG node ends many
+ * words, so the id of a word is instead its rank in alphabetical order: every edge records the number of words
+ * that sort before those reached through it, and the rank is summed as the word is descended.
+ * 
+ * Every node also records its height, the number of letters in the longest word continuing its prefix, so a search
+ * can abandon a prefix whose words are all too short to be wanted.
+ */
+class FlatDictionary
+{
+  public:
+    /// Identifies a node of the structure. Node ids are dense, in the range [0, getNodeCount()).
+    using NodeId = uint32_t;
+
+    /// Identifies a word, or a prefix of a word, of the structure. Word ids are dense, in the range [0, getWordIdCount()).
+    using WordId = uint32_t;
+
+    /**
+     * The ways the nodes of the structure can be laid out.
+     * TRIE = every prefix has its own node.
+     * DAWG = prefixes continued by the same set of suffixes share a node.
+     */
+    enum LAYOUT
+    {
+        TRIE,
+        DAWG
+    };
+
+    /// The id of the root node, representing the empty word.
+    static constexpr NodeId ROOT = 0;
+    /// Represents a child that does not exist.
+    static constexpr NodeId NO_NODE = UINT32_MAX;
+    /// The height of a node whose longest continuation is too long to be recorded.
+    static constexpr size_t UNBOUNDED_HEIGHT = SIZE_MAX;
+
+    /**
+     * Constructor that compiles the provided dictionary into the flat layout.
+     * The provided dictionary is not modified and may be destroyed afterwards.
+     * 
+     * @param dictionary: the dictionary to compile
+     */
+    explicit FlatDictionary(const Dictionary& dictionary);
+
+    FlatDictionary(const FlatDictionary&) = delete;
+    FlatDictionary& operator=(const FlatDictionary&) = delete;
+    FlatDictionary(FlatDictionary&&) = default;
+    FlatDictionary& operator=(FlatDictionary&&) = default;
+
+    /**
+     * Memory maps a binary image written by save() and queries it in place.
+     * 
+     * An exception will be thrown if the file cannot be located/accessed, or is not an image of a
+     * compatible version and byte order. Every node and edge is checked once as the image is mapped, so an image
+     * whose arrays are corrupt is rejected rather than queried out of bounds.
+     * 
+     * @param path: the file name/path of the image
+     * @return a dictionary backed by the mapped image
+     */
+    static FlatDictionary load(const std::string& path);
+    /**
+     * Writes the structure as a binary image that can be loaded with load().
+     * The image is written beside the path and renamed into place, so a reader never maps a partial image.
+     * 
+     * An exception will be thrown if the image cannot be written.
+     * 
+     * @param path: the file name/path of the image
+     */
+    void save(const std::string& path) const;
+    /**
+     * Attempts to find a word in the dictionary.
+     * 
+     * @param word: the word to search for in the dictionary
+     * @return the status of the search. See Dictionary::SEARCH_STATUS for more information on the possible return values.
+     */
+    Dictionary::SEARCH_STATUS find(const std::string& word) const;
+    /**
+     * Gets the number of nodes in the structure, including the root.
+     * 
+     * @return the number of nodes in the structure
+     */
+    size_t getNodeCount(void) const;
+    /**
+     * Gets the number of bytes used by the nodes and edges of the structure.
+     * 
+     * @return the number of bytes used by the structure
+     */
+    size_t getSizeInBytes(void) const;
+    /**
+     * Gets the child of a node for a letter.
+     * 
+     * @param node: the id of the parent node
+     * @param letter: the index of the letter in the alphabet (A = 0, ..., Z = 25)
+     * @return the id of the child node, or NO_NODE if the letter does not continue the node's prefix
+     */
+    NodeId getChild(NodeId node, unsigned char letter) const;
+    /**
+     * Gets the child of a node for a letter, along with the id of the prefix the child represents.
+     * 
+     * @param node: the id of the parent node
+     * @param letter: the index of the letter in the alphabet (A = 0, ..., Z = 25)
+     * @param id: the id of the prefix the parent node represents, replaced by that of the child's prefix
+     * @return the id of the child node, or NO_NODE if the letter does not continue the node's prefix
+     */
+    NodeId getChild(NodeId node, unsigned char letter, WordId& id) const;
+    /**
+     * Gets the letters that have a child under a node.
+     * 
+     * @param node: the id of the node
+     * @return a mask with bit 0 set for A, ..., bit 25 set for Z
+     */
+    uint32_t getChildMask(NodeId node) const;
+    /**
+     * Determines whether the path from the root to a node spells a word.
+     * 
+     * @param node: the id of the node
+     * @return true if the node is the end node in a word, else false
+     */
+    bool getIsWord(NodeId node) const;
+    /**
+     * Gets the status a search for the prefix a node represents ends with.
+     * 
+     * @param node: the id of the node, or NO_NODE if a letter of the prefix was absent from the structure
+     * @return the status of the search. See Dictionary::SEARCH_STATUS for more information on the possible return values.
+     */
+    Dictionary::SEARCH_STATUS getStatus(NodeId node) const;
+    /**
+     * Gets the height of a node: the number of letters in the longest word continuing the node's prefix.
+     * 
+     * @param node: the id of the node
+     * @return the number of letters that can follow the prefix, 0 if no word continues it,
+     * or UNBOUNDED_HEIGHT if it is 255 letters or more
+     */
+    size_t getHeight(NodeId node) const;
+    /**
+     * Gets the layout of the nodes of the structure.
+     * 
+     * @return TRIE or DAWG
+     */
+    LAYOUT getLayout(void) const;
+    /**
+     * Gets the number of word ids of the structure. Every word has an id below this number.
+     * 
+     * @return the number of nodes of a trie, or the number of words of a DAWG
+     */
+    size_t getWordIdCount(void) const;
+    /**
+     * Gets the parent of a node of a trie.
+     * 
+     * @param node: the id of the node
+     * @return the id of the parent node, or NO_NODE for the root or for any node of a DAWG
+     */
+    NodeId getParent(NodeId node) const;
+    /**
+     * Spells a word from its id.
+     * 
+     * @param id: the id of the word
+     * @return the letters of the word, in uppercase
+     */
+    std::string getWord(WordId id) const;
+    /**
+     * Spells a word from its id into an existing string, reusing its storage.
+     * 
+     * @param id: the id of the word
+     * @param word: receives the letters of the word, in uppercase
+     */
+    void getWord(WordId id, std::string& word) const;
+    /**
+     * Gets the maximum length of the words read from the dictionary file the structure was built from.
+     * Words longer than this may have been left out.
+     * 
+     * @return the maximum length of the words read from the dictionary file
+     */
+    size_t getMaximumWordSize(void) const;
+    /**
+     * Gets the number of letters in the longest word of the structure, measured by walking every node once.
+     * 
+     * @return the number of letters in the longest word, or 0 if the structure holds no word
+     */
+    size_t getLongestWordSize(void) const;
+
+    /**
+     * A position in the FlatDictionary that moves one letter at a time.
+     * Behaves as Dictionary::Cursor does. The cursor must not outlive the FlatDictionary it was created from.
+     */
+    class Cursor
+    {
+      public:
+        /**
+         * Constructor. The cursor starts at the root of the dictionary, representing the empty word.
+         * 
+         * @param dictionary: the dictionary to traverse
+         */
+        explicit Cursor(const FlatDictionary& dictionary);
+        /**
+         * Appends a letter to the word represented by the cursor.
+         * 
+         * @param letter: the letter to append, expected in the range [a-z][A-Z]
+         * @return the status of the word now represented by the cursor
+         */
+        Dictionary::SEARCH_STATUS descend(char letter);
+        /**
+         * Drops the final letter of the word represented by the cursor.
+         * Has no effect if the cursor is at the root.
+         */
+        void ascend(void);
+        /**
+         * Moves the cursor back to the root, representing the empty word.
+         */
+        void reset(void);
+        /**
+         * Gets the status of the word represented by the cursor, equivalent to calling find() with that word.
+         * 
+         * @return the status of the word represented by the cursor
+         */
+        Dictionary::SEARCH_STATUS status(void) const;
+        /**
+         * Gets the letters that extend the word represented by the cursor to a prefix present in the dictionary.
+         * 
+         * @return a mask with bit 0 set for A, ..., bit 25 set for Z, or 0 if the word is absent from the dictionary
+         */
+        uint32_t getChildMask(void) const;
+        /**
+         * Gets the node representing the word of the cursor.
+         * 
+         * @return the id of the node, or NO_NODE if the word is absent from the dictionary
+         */
+        NodeId getNode(void) const;
+        /**
+         * Gets the id of the word, or prefix of a word, represented by the cursor.
+         * Two prefixes of the same length have the same id only if they are the same prefix.
+         * 
+         * @return the id of the word, or an unspecified value if the word is absent from the dictionary
+         */
+        WordId getWordId(void) const;
+        /**
+         * Gets the number of letters in the word represented by the cursor.
+         * 
+         * @return the number of letters in the word represented by the cursor
+         */
+        size_t depth(void) const;
+
+      private:
+        const FlatDictionary& dictionary;
+        // The node indices visited from the root to the current letter. NO_NODE marks a letter absent from the dictionary.
+        std::vector<uint32_t> path;
+        // The word ids of the prefixes visited from the root to the current letter.
+        std::vector<WordId> ids;
+    };
+
+  private:
+    // Allows the DawgBuilder class to assemble a structure from the nodes it minimizes.
+    friend class DawgBuilder;
+
+    /**
+     * A single node in the flat structure.
+     * The lower 26 bits of the mask flag the letters that have a child, and the highest bit flags the end of a word.
+     */
+    struct Node
+    {
+        uint32_t mask = 0;
+        uint32_t firstEdge = 0;
+    };
+
+    // Flags a node as the end node in a word.
+    static constexpr uint32_t WORD_FLAG = 1u << 31;
+    // Selects the child letters from a node mask.
+    static constexpr uint32_t LETTER_MASK = (1u << Utils::LETTERS_IN_ALPHABET) - 1;
+    // Heights are stored in a byte per node. Longer continuations are recorded as this height.
+    static constexpr unsigned char MAXIMUM_RECORDED_HEIGHT = UINT8_MAX;
+
+    /**
+     * The header at the start of a binary image.
+     * The node array follows the header and the edge array follows the node array. In a trie the parent and letter
+     * arrays follow the edge array; in a DAWG the edge rank array does. The height array comes last.
+     */
+    struct ImageHeader
+    {
+        char magic[8];
+        uint32_t version;
+        // Written as 1 so that an image from a machine of a different byte order is rejected.
+        uint32_t byteOrder;
+        uint64_t maximumWordSize;
+        uint64_t nodeCount;
+        uint64_t edgeCount;
+        uint32_t layout;
+        uint32_t reserved;
+        uint64_t wordIdCount;
+    };
+
+    // Identifies a binary image.
+    static constexpr char IMAGE_MAGIC[8] = { 'L', 'W', 'T', 'R', 'I', 'E', '\0', '\0' };
+    // Increased whenever the layout of the image changes.
+    static constexpr uint32_t IMAGE_VERSION = 4;
+
+    // The storage of a structure compiled in memory. Empty for a structure backed by an image.
+    std::vector<Node> ownedNodes;
+    std::vector<uint32_t> ownedEdges;
+    std::vector<uint32_t> ownedParents;
+    std::vector<unsigned char> ownedLetters;
+    std::vector<uint32_t> ownedEdgeRanks;
+    std::vector<unsigned char> ownedHeights;
+    // The image backing a loaded structure, or nullptr for a structure compiled in memory.
+    std::unique_ptr<MappedFile> image;
+
+    // The nodes of the structure, the root first.
+    const Node* nodes = nullptr;
+    size_t nodeCount = 0;
+    // The child node indices of every node, grouped per node and ordered by letter.
+    const uint32_t* edges = nullptr;
+    size_t edgeCount = 0;
+    LAYOUT layout = TRIE;
+    size_t wordIdCount = 0;
+    // In a trie, the parent node index of every node, NO_NODE for the root. nullptr in a DAWG.
+    const uint32_t* parents = nullptr;
+    // In a trie, the letter leading from the parent to every node, 0 for the root. nullptr in a DAWG.
+    const unsigned char* letters = nullptr;
+    // In a DAWG, the amount every edge adds to the rank of a prefix: the number of words below its node that sort
+    // before those reached through the edge. nullptr in a trie.
+    const uint32_t* edgeRanks = nullptr;
+    // The height of every node, capped at MAXIMUM_RECORDED_HEIGHT.
+    const unsigned char* heights = nullptr;
+    size_t maximumWordSize = SIZE_MAX;
+
+    // Constructor for a structure backed by a mapped image.
+    explicit FlatDictionary(std::unique_ptr<MappedFile> image);
+    // Constructor for a DAWG from its nodes and edges, ordered so that every child precedes its parent, the root aside.
+    FlatDictionary(std::vector<Node> nodes, std::vector<uint32_t> edges, size_t maximumWordSize);
+
+    // Checks that the arrays of a mapped image are consistent, so no query on them can leave their bounds or loop.
+    // Throws std::invalid_argument if they are not.
+    void validate(void) const;
+    // Records the height of a node of a structure being built, from the heights of its children.
+    void measureHeight(uint32_t index);
+
+    // Gets the index of the edge from a node for a letter, or NO_NODE if the letter does not continue the node's prefix.
+    uint32_t getEdge(NodeId node, unsigned char letter) const;
+};
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <optional>
+#include <utility>
+#include <cstddef>
+
+/**
+ * A lazily evaluated sequence of values, produced by a coroutine that yields each value with co_yield.
+ *
+ * The coroutine starts suspended and runs only while the sequence is advanced, up to its next co_yield, so a
+ * consumer that stops iterating never pays for the values it did not pull. Destroying the generator destroys
+ * the suspended coroutine with every local it holds. An exception thrown by the coroutine is rethrown to the
+ * consumer by the call that advanced it.
+ *
+ * The generator is an input range: it is iterated once, with a range-based for loop or begin() and end().
+ *
+ * Example:
+ * Generator<int> count(int n) { for(int i = 0; i < n; i++) co_yield i; }
+ */
+template <typename T>
+class Generator
+{
+  public:
+    /// The state shared between the coroutine and the generator. Required by the coroutine machinery.
+    class promise_type
+    {
+      public:
+        Generator get_return_object(void)
+        {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend(void) const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_always final_suspend(void) const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_always yield_value(T yielded)
+        {
+            value.emplace(std::move(yielded));
+            return {};
+        }
+
+        void return_void(void) const noexcept {}
+
+        void unhandled_exception(void)
+        {
+            exception = std::current_exception();
+        }
+
+        // Disallows co_await in the body, as a generator only suspends to yield.
+        template <typename U>
+        std::suspend_never await_transform(U&&) = delete;
+
+      private:
+        friend class Generator;
+
+        // The value most recently yielded.
+        std::optional<T> value;
+        // The exception that ended the coroutine, rethrown to the consumer.
+        std::exception_ptr exception;
+    };
+
+    /// Moves through the values of the generator, resuming the coroutine once per value.
+    class iterator
+    {
+      public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator(void) = default;
+
+        const T& operator*(void) const
+        {
+            return *coroutine.promise().value;
+        }
+
+        const T* operator->(void) const
+        {
+            return &*coroutine.promise().value;
+        }
+
+        iterator& operator++(void)
+        {
+            advance(coroutine);
+            return *this;
+        }
+
+        void operator++(int)
+        {
+            ++*this;
+        }
+
+        friend bool operator==(const iterator& it, std::default_sentinel_t)
+        {
+            return it.coroutine == nullptr || it.coroutine.done();
+        }
+
+      private:
+        friend class Generator;
+
+        explicit iterator(std::coroutine_handle<promise_type> coroutine) : coroutine(coroutine) {}
+
+        std::coroutine_handle<promise_type> coroutine;
+    };
+
+    Generator(Generator&& other) noexcept : coroutine(std::exchange(other.coroutine, nullptr)) {}
+
+    Generator& operator=(Generator&& other) noexcept
+    {
+        if(this != &other)
+        {
+            destroy();
+            coroutine = std::exchange(other.coroutine, nullptr);
+        }
+
+        return *this;
+    }
+
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) = delete;
+
+    ~Generator(void)
+    {
+        destroy();
+    }
+
+    /**
+     * Runs the coroutine up to its first value. Must be called once, before the values are read.
+     *
+     * @return an iterator positioned on the first value, or equal to end() if the coroutine yields none
+     */
+    iterator begin(void)
+    {
+        advance(coroutine);
+        return iterator(coroutine);
+    }
+
+    /**
+     * Gets the sentinel an iterator compares equal to once the coroutine has finished.
+     *
+     * @return the end of the sequence
+     */
+    std::default_sentinel_t end(void) const noexcept
+    {
+        return std::default_sentinel;
+    }
+
+  private:
+    std::coroutine_handle<promise_type> coroutine;
+
+    explicit Generator(std::coroutine_handle<promise_type> coroutine) : coroutine(coroutine) {}
+
+    // Resumes the coroutine up to its next value or its end, rethrowing any exception it ended with.
+    static void advance(std::coroutine_handle<promise_type> coroutine)
+    {
+        if(coroutine == nullptr || coroutine.done())
+        {
+            return;
+        }
+
+        coroutine.promise().value.reset();
+        coroutine.resume();
+
+        if(coroutine.promise().exception)
+        {
+            std::rethrow_exception(std::exchange(coroutine.promise().exception, nullptr));
+        }
+    }
+
+    void destroy(void)
+    {
+        if(coroutine != nullptr)
+        {
+            coroutine.destroy();
+        }
+    }
+};
@@ -0,0 +1,156 @@
+#include "IncrementalSolver.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <bit>
+#include <stdexcept>
+#include <algorithm>
+
+#include "Wheels.h"
+#include "Alphabet.h"
+#include "FlatDictionary.h"
+#include "WordSet.h"
+
+IncrementalSolver::IncrementalSolver(const Wheels& wheels, const FlatDictionary& dictionary) :
+    dictionary(dictionary), lettersPerWheel(wheels.getLettersPerWheel()),
+    longestSpan(std::max<size_t>(dictionary.getLongestWordSize(), 2)), spans(dictionary.getWordIdCount(), 0),
+    result(dictionary)
+{
+    for(size_t wheel = 0; wheel < wheels.getNumberOfWheels(); wheel++)
+    {
+        wheelMasks.push_back(wheels.getWheelMask(wheel));
+    }
+
+    // A word needs a second wheel, so the final wheel never starts one.
+    for(size_t start = 0; start + 1 < wheelMasks.size(); start++)
+    {
+        count(start, 2, true);
+    }
+}
+
+IncrementalSolver::Change IncrementalSolver::replaceWheel(size_t wheel, std::string_view letters)
+{
+    if(wheel >= wheelMasks.size())
+    {
+        throw std::invalid_argument("There is no wheel " + std::to_string(wheel) + ". The wheels are numbered from 0 to "
+            + std::to_string(wheelMasks.size() - 1) + ".");
+    }
+
+    if(letters.size() != lettersPerWheel || !Alphabets::isValidString<LatinAlphabet>(letters))
+    {
+        throw std::invalid_argument("A wheel must hold " + std::to_string(lettersPerWheel) + " letters in the range of "
+            + LatinAlphabet::DESCRIPTION + ". Value: " + std::string(letters));
+    }
+
+    uint32_t mask = 0;
+
+    for(char letter : letters)
+    {
+        mask |= 1u << LatinAlphabet::INDEX[static_cast<unsigned char>(letter)];
+    }
+
+    // Only the start wheels from which a word can reach the replaced wheel are searched again. Of their words,
+    // only those long enough to reach it are counted; the shorter ones are formed as before.
+    const size_t first = wheel + 1 >= longestSpan ? wheel + 1 - longestSpan : 0;
+    const size_t last = std::min(wheel + 1, wheelMasks.size() - 1);
+    std::vector<FlatDictionary::WordId> changed;
+
+    touched = &changed;
+
+    for(size_t start = first; start < last; start++)
+    {
+        count(start, std::max<size_t>(wheel - start + 1, 2), false);
+    }
+
+    wheelMasks[wheel] = mask;
+
+    for(size_t start = first; start < last; start++)
+    {
+        count(start, std::max<size_t>(wheel - start + 1, 2), true);
+    }
+
+    touched = nullptr;
+
+    // A word withdrawn from one span and added by another is in the result before and after, so it did not change.
+    Change change;
+
+    for(FlatDictionary::WordId id : changed)
+    {
+        if(spans[id] > 0 && result.insert(id))
+        {
+            change.added.push_back(id);
+        }
+        else if(spans[id] == 0 && result.erase(id))
+        {
+            change.removed.push_back(id);
+        }
+    }
+
+    return change;
+}
+
+const WordSet& IncrementalSolver::getResult(void) const
+{
+    return result;
+}
+
+uint32_t IncrementalSolver::getSpanCount(FlatDictionary::WordId id) const
+{
+    return spans[id];
+}
+
+void IncrementalSolver::count(size_t start, size_t minimumLength, bool isAdding)
+{
+    startWheel = start;
+    this->minimumLength = minimumLength;
+    this->isAdding = isAdding;
+
+    visit(FlatDictionary::ROOT, 0, 0);
+}
+
+void IncrementalSolver::visit(FlatDictionary::NodeId node, FlatDictionary::WordId id, size_t length)
+{
+    const size_t wheel = startWheel + length;
+    const bool hasNextWheel = wheel + 1 < wheelMasks.size();
+
+    // Visits each set bit, lowest letter first, clearing it once visited.
+    for(uint32_t letters = wheelMasks[wheel] & dictionary.getChildMask(node); letters != 0; letters &= letters - 1)
+    {
+        const unsigned char letter = static_cast<unsigned char>(std::countr_zero(letters));
+        FlatDictionary::WordId childId = id;
+        const FlatDictionary::NodeId child = dictionary.getChild(node, letter, childId);
+
+        if(length + 1 >= minimumLength && dictionary.getIsWord(child))
+        {
+            uint32_t& spanCount = spans[childId];
+
+            if(isAdding)
+            {
+                spanCount++;
+            }
+            else
+            {
+                spanCount--;
+            }
+
+            // The first span found adds the word, and withdrawing the last one removes it.
+            if(spanCount == (isAdding ? 1u : 0u))
+            {
+                if(touched != nullptr)
+                {
+                    touched->push_back(childId);
+                }
+                else if(isAdding)
+                {
+                    result.insert(childId);
+                }
+            }
+        }
+
+        if(hasNextWheel)
+        {
+            visit(child, childId, length + 1);
+        }
+    }
+}
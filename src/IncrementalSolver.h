@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "Wheels.h"
+#include "FlatDictionary.h"
+#include "WordSet.h"
+
+/**
+ * Keeps the words formed by a series of lettered wheels up to date as individual wheels are replaced.
+ *
+ * For each word found, the solver counts the start wheels it can be formed from. Replacing a wheel only affects the
+ * words whose span covers it, and those start no more than the length of the longest dictionary word before it.
+ * So only those start wheels are searched: once with the old wheel, to withdraw the spans they formed, and once
+ * with the new wheel. A word leaves the result when its last span is withdrawn, so a word still formed elsewhere stays.
+ * The cost of an edit depends on the depth of the dictionary, not on the number of wheels.
+ *
+ * The solver must not outlive the FlatDictionary it was created for, and the dictionary must not have been
+ * built for the original wheels alone, as the replaced wheels may form words they could not.
+ */
+class IncrementalSolver
+{
+  public:
+    /// The words a replacement added to or removed from the result.
+    struct Change
+    {
+        std::vector<FlatDictionary::WordId> added;
+        std::vector<FlatDictionary::WordId> removed;
+    };
+
+    /**
+     * Constructor. Finds every word formed by the wheels.
+     *
+     * @param wheels: the lettered wheels to search. Only the letters each wheel offers are kept.
+     * @param dictionary: the dictionary to cross-reference the permutations with
+     */
+    IncrementalSolver(const Wheels& wheels, const FlatDictionary& dictionary);
+    /**
+     * Replaces the letters of a wheel and updates the result.
+     *
+     * An exception will be thrown if the wheel does not exist, or the letters are not lettersPerWheel letters of the
+     * range {[a-z][A-Z]}. The result is unchanged in that case.
+     *
+     * @param wheel: the index of the wheel to replace
+     * @param letters: the new letters of the wheel, in either case
+     * @return the words added to and removed from the result by the replacement
+     */
+    Change replaceWheel(size_t wheel, std::string_view letters);
+    /**
+     * Gets the words currently formed by the wheels.
+     *
+     * @return the collection of unique words formed by the wheels and present in the dictionary
+     */
+    const WordSet& getResult(void) const;
+    /**
+     * Gets the number of start wheels a word is currently formed from.
+     *
+     * @param id: the id of the word
+     * @return the number of start wheels forming the word, 0 if it is not in the result
+     */
+    uint32_t getSpanCount(FlatDictionary::WordId id) const;
+
+  private:
+    const FlatDictionary& dictionary;
+    const size_t lettersPerWheel;
+    // The distinct letters on each wheel, one bit per letter.
+    std::vector<uint32_t> wheelMasks;
+    // The number of wheels a word can span, at most the length of the longest dictionary word.
+    const size_t longestSpan;
+    // For each word id, the number of start wheels the word is formed from.
+    std::vector<uint32_t> spans;
+    WordSet result;
+
+    // The search in progress: its start wheel, the shortest word it counts and whether spans are added or withdrawn.
+    size_t startWheel = 0;
+    size_t minimumLength = 0;
+    bool isAdding = true;
+    // The words whose span count reached or left 0 during the search, or nullptr to update the result as they do.
+    std::vector<FlatDictionary::WordId>* touched = nullptr;
+
+    /**
+     * Adds or withdraws the spans starting at a wheel, of the words at least minimumLength letters long.
+     *
+     * @param start: the index of the start wheel
+     * @param minimumLength: the length of the shortest word to count
+     * @param isAdding: true to add the spans, false to withdraw them
+     */
+    void count(size_t start, size_t minimumLength, bool isAdding);
+    /**
+     * Counts every word continuing the prefix at a node, visiting only the letters both on the next wheel and
+     * under the node.
+     *
+     * @param node: the node of the prefix
+     * @param id: the word id of the prefix
+     * @param length: the number of letters in the prefix
+     */
+    void visit(FlatDictionary::NodeId node, FlatDictionary::WordId id, size_t length);
+};
@@ -0,0 +1,132 @@
+#include "MappedFile.h"
+
+#include <string>
+#include <string_view>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& path, ACCESS_PATTERN pattern)
+{
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        pattern == SEQUENTIAL ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS, nullptr);
+
+    if(fileHandle == INVALID_HANDLE_VALUE)
+    {
+        fileHandle = nullptr;
+        throw std::invalid_argument("Unable to locate / access the file with path : " + path);
+    }
+
+    LARGE_INTEGER fileSize;
+
+    if(!GetFileSizeEx(fileHandle, &fileSize))
+    {
+        CloseHandle(fileHandle);
+        throw std::invalid_argument("Unable to read the size of the file with path : " + path);
+    }
+
+    size = static_cast<size_t>(fileSize.QuadPart);
+
+    // An empty file cannot be mapped, and has no contents to view.
+    if(size == 0)
+    {
+        return;
+    }
+
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    data = mappingHandle == nullptr ? nullptr : static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+
+    if(data == nullptr)
+    {
+        if(mappingHandle != nullptr)
+        {
+            CloseHandle(mappingHandle);
+        }
+
+        CloseHandle(fileHandle);
+        throw std::invalid_argument("Unable to map the file with path : " + path);
+    }
+}
+
+MappedFile::~MappedFile(void)
+{
+    if(data != nullptr)
+    {
+        UnmapViewOfFile(data);
+    }
+
+    if(mappingHandle != nullptr)
+    {
+        CloseHandle(mappingHandle);
+    }
+
+    if(fileHandle != nullptr)
+    {
+        CloseHandle(fileHandle);
+    }
+}
+#else
+MappedFile::MappedFile(const std::string& path, ACCESS_PATTERN pattern)
+{
+    fileDescriptor = open(path.c_str(), O_RDONLY);
+
+    if(fileDescriptor < 0)
+    {
+        throw std::invalid_argument("Unable to locate / access the file with path : " + path);
+    }
+
+    struct stat status;
+
+    if(fstat(fileDescriptor, &status) != 0)
+    {
+        close(fileDescriptor);
+        throw std::invalid_argument("Unable to read the size of the file with path : " + path);
+    }
+
+    size = static_cast<size_t>(status.st_size);
+
+    // An empty file cannot be mapped, and has no contents to view.
+    if(size == 0)
+    {
+        return;
+    }
+
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+    if(mapping == MAP_FAILED)
+    {
+        close(fileDescriptor);
+        throw std::invalid_argument("Unable to map the file with path : " + path);
+    }
+
+    madvise(mapping, size, pattern == SEQUENTIAL ? MADV_SEQUENTIAL : MADV_RANDOM);
+    data = static_cast<const char*>(mapping);
+}
+
+MappedFile::~MappedFile(void)
+{
+    if(data != nullptr)
+    {
+        munmap(const_cast<char*>(data), size);
+    }
+
+    if(fileDescriptor >= 0)
+    {
+        close(fileDescriptor);
+    }
+}
+#endif
+
+std::string_view MappedFile::getContents(void) const
+{
+    return data == nullptr ? std::string_view() : std::string_view(data, size);
+}
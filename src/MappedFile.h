@@ -0,0 +1,96 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstring>
+
+/**
+ * A read-only view of a whole file, mapped into memory.
+ * 
+ * The bytes of the file are read in place, without being copied into a buffer or stream.
+ * The mapping is released when the object is destroyed, invalidating every view taken from it.
+ */
+class MappedFile
+{
+  public:
+    /**
+     * The expected order in which the mapped bytes are read, used to tune how the file is paged in.
+     * SEQUENTIAL = the file is read once from start to end.
+     * RANDOM = the file is read at scattered positions, such as by queries on a structure stored in it.
+     */
+    enum ACCESS_PATTERN
+    {
+        SEQUENTIAL,
+        RANDOM
+    };
+
+    /**
+     * Constructor. Maps the file at the given path into memory.
+     * 
+     * An exception will be thrown if the file cannot be located/accessed or mapped.
+     * 
+     * @param path: the file name/path of the file to map
+     * @param pattern: the expected order in which the mapped bytes are read
+     */
+    explicit MappedFile(const std::string& path, ACCESS_PATTERN pattern = SEQUENTIAL);
+    ~MappedFile(void);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Gets the contents of the file.
+     * 
+     * @return a view of every byte in the file
+     */
+    std::string_view getContents(void) const;
+
+    /**
+     * Visits each line of a range of a mapped file, without its line ending.
+     * Lines may end with "\n" or "\r\n", and the final line may be unterminated.
+     * 
+     * @param position: the start of the first line
+     * @param end: one past the final character of the range
+     * @param visit: called with each line, returning false to stop visiting
+     */
+    template <typename Visit>
+    static void forEachLine(const char* position, const char* const end, Visit visit)
+    {
+        while(position < end)
+        {
+            // Finds the end of the current line, or the end of the range if the final line is unterminated.
+            const char* lineEnd = static_cast<const char*>(std::memchr(position, '\n', end - position));
+
+            if(lineEnd == nullptr)
+            {
+                lineEnd = end;
+            }
+
+            std::string_view line(position, lineEnd - position);
+
+            // Ignores the carriage return of a line ending in "\r\n".
+            if(!line.empty() && line.back() == '\r')
+            {
+                line.remove_suffix(1);
+            }
+
+            if(!visit(line))
+            {
+                return;
+            }
+
+            position = lineEnd + 1;
+        }
+    }
+
+  private:
+    const char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fileDescriptor = -1;
+#endif
+};
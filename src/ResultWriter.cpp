@@ -0,0 +1,177 @@
+#include "ResultWriter.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <ostream>
+#include <utility>
+#include <algorithm>
+
+#include "WordSet.h"
+#include "FlatDictionary.h"
+#include "Utils.h"
+
+namespace
+{
+    /**
+     * Sorts the words in the range [begin, end), which share their first depth letters, by their remaining letters.
+     * 
+     * @param words: the words being sorted
+     * @param scratch: storage the size of words, used to distribute each range
+     * @param begin: the first word of the range
+     * @param end: one past the last word of the range
+     * @param depth: the number of letters shared by every word of the range
+     */
+    void radixSort(std::vector<std::string>& words, std::vector<std::string>& scratch, size_t begin, size_t end, size_t depth)
+    {
+        if(end - begin < 2)
+        {
+            return;
+        }
+
+        // Bucket 0 holds the words ending at this depth, which sort first. Buckets 1 to 26 hold the letters A to Z.
+        constexpr size_t BUCKETS = Utils::LETTERS_IN_ALPHABET + 1;
+        const auto bucketOf = [depth](const std::string& word)
+        {
+            return depth < word.size() ? static_cast<size_t>(word[depth] - 'A') + 1 : 0;
+        };
+
+        std::array<size_t, BUCKETS + 1> starts = {};
+
+        for(size_t i = begin; i < end; i++)
+        {
+            starts[bucketOf(words[i]) + 1]++;
+        }
+
+        for(size_t bucket = 0; bucket < BUCKETS; bucket++)
+        {
+            starts[bucket + 1] += starts[bucket];
+        }
+
+        // Distributes the range into its buckets, keeping the order of words within a bucket.
+        std::array<size_t, BUCKETS> next;
+        std::copy(starts.begin(), starts.end() - 1, next.begin());
+
+        for(size_t i = begin; i < end; i++)
+        {
+            scratch[begin + next[bucketOf(words[i])]++] = std::move(words[i]);
+        }
+
+        for(size_t i = begin; i < end; i++)
+        {
+            words[i] = std::move(scratch[i]);
+        }
+
+        // The words ending at this depth are equal, so only the letter buckets are sorted further.
+        for(size_t bucket = 1; bucket < BUCKETS; bucket++)
+        {
+            radixSort(words, scratch, begin + starts[bucket], begin + starts[bucket + 1], depth + 1);
+        }
+    }
+}
+
+ResultWriter::ResultWriter(std::ostream& stream) : stream(stream)
+{
+    buffer.reserve(CHUNK_SIZE);
+}
+
+ResultWriter::~ResultWriter(void)
+{
+    flush();
+}
+
+void ResultWriter::append(std::string_view text)
+{
+    buffer.append(text);
+
+    if(buffer.size() >= CHUNK_SIZE)
+    {
+        stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+}
+
+void ResultWriter::flush(void)
+{
+    if(!buffer.empty())
+    {
+        stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+
+    stream.flush();
+}
+
+void ResultWriter::appendWord(std::string_view word, Utils::Options::FORMAT format)
+{
+    const bool isJson = format == Utils::Options::JSON_LINES;
+
+    // Words only hold the letters [A-Z], so they never need escaping.
+    append(isJson ? "{\"word\":\"" : "");
+    append(word);
+    append(isJson ? "\"}\n" : "\n");
+}
+
+void ResultWriter::appendCount(size_t count, Utils::Options::FORMAT format)
+{
+    const bool isJson = format == Utils::Options::JSON_LINES;
+
+    append(isJson ? "{\"found\":" : "Found ");
+    append(std::to_string(count));
+    append(isJson ? "}\n" : " unique words\n");
+}
+
+void ResultWriter::appendEdit(std::string_view word, bool isAdded, Utils::Options::FORMAT format)
+{
+    if(format == Utils::Options::JSON_LINES)
+    {
+        append(isAdded ? "{\"added\":\"" : "{\"removed\":\"");
+        append(word);
+        append("\"}\n");
+        return;
+    }
+
+    append(isAdded ? "+" : "-");
+    append(word);
+    append("\n");
+}
+
+void ResultWriter::write(const WordSet& result, const Utils::Options& options, std::ostream& stream)
+{
+    ResultWriter writer(stream);
+
+    if(!options.countOnly)
+    {
+        if(options.sortOutput)
+        {
+            std::vector<std::string> words = result.getWords();
+            sort(words);
+
+            for(const std::string& word : words)
+            {
+                writer.appendWord(word, options.format);
+            }
+        }
+        else
+        {
+            // One string is reused to spell every word, so nothing is allocated per word.
+            std::string word;
+
+            for(FlatDictionary::WordId id : result.getWordIds())
+            {
+                result.getDictionary().getWord(id, word);
+                writer.appendWord(word, options.format);
+            }
+        }
+    }
+
+    writer.appendCount(result.size(), options.format);
+}
+
+void ResultWriter::sort(std::vector<std::string>& words)
+{
+    std::vector<std::string> scratch(words.size());
+
+    radixSort(words, scratch, 0, words.size(), 0);
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <ostream>
+
+#include "WordSet.h"
+#include "Utils.h"
+
+/**
+ * Writes the words found by a search to a stream.
+ * 
+ * Output is gathered in a large buffer and handed to the stream one chunk at a time, rather than flushed per line.
+ * The words can be written as plain text or as JSON lines, in node order or alphabetical order, or left out so
+ * that only the number of words found is written.
+ */
+class ResultWriter
+{
+  public:
+    /**
+     * Constructor.
+     * 
+     * @param stream: the stream to write to. It must outlive the writer.
+     */
+    explicit ResultWriter(std::ostream& stream);
+    /**
+     * Destructor. Writes any buffered output to the stream.
+     */
+    ~ResultWriter(void);
+
+    ResultWriter(const ResultWriter&) = delete;
+    ResultWriter& operator=(const ResultWriter&) = delete;
+
+    /**
+     * Appends text to the buffer, writing the buffer to the stream once it holds a full chunk.
+     * 
+     * @param text: the text to append
+     */
+    void append(std::string_view text);
+    /**
+     * Writes the buffered output to the stream and flushes the stream.
+     */
+    void flush(void);
+    /**
+     * Appends a found word, as a line of text or as a {"word":"..."} object.
+     * 
+     * @param word: the word to append
+     * @param format: the format to append the word in
+     */
+    void appendWord(std::string_view word, Utils::Options::FORMAT format);
+    /**
+     * Appends the number of words found, as a "Found N unique words" line or as a {"found":N} object.
+     * 
+     * @param count: the number of words found
+     * @param format: the format to append the count in
+     */
+    void appendCount(size_t count, Utils::Options::FORMAT format);
+    /**
+     * Appends a word added to or removed from a result, as a "+WORD" or "-WORD" line of text,
+     * or as an {"added":"..."} or {"removed":"..."} object.
+     * 
+     * @param word: the word added or removed
+     * @param isAdded: true if the word was added, false if it was removed
+     * @param format: the format to append the word in
+     */
+    void appendEdit(std::string_view word, bool isAdded, Utils::Options::FORMAT format);
+    /**
+     * Writes every word in a collection followed by the number of words, as selected by the options.
+     * 
+     * Text output is one word per line and a final "Found N unique words" line.
+     * JSON lines output is one {"word":"..."} object per line and a final {"found":N} object.
+     * With --count-only only the final line is written, and no word is spelled.
+     * 
+     * @param result: the collection of words to write
+     * @param options: the options selecting the format, order and content of the output
+     * @param stream: the stream to write to
+     */
+    static void write(const WordSet& result, const Utils::Options& options, std::ostream& stream);
+    /**
+     * Sorts words made of the letters [A-Z] into alphabetical order with a most significant digit radix sort.
+     * A word sorts before every longer word it is a prefix of.
+     * 
+     * @param words: the words to sort, in place
+     */
+    static void sort(std::vector<std::string>& words);
+
+  private:
+    // The size of the chunks handed to the stream.
+    static constexpr size_t CHUNK_SIZE = 1 << 16;
+
+    std::ostream& stream;
+    std::string buffer;
+};
@@ -0,0 +1,830 @@
+#include "Search.h"
+
+#include <unordered_set>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+#include "Generator.h"
+#include "Wheels.h"
+#include "Dictionary.h"
+#include "FlatDictionary.h"
+#include "WordSet.h"
+#include "WorkStealingPool.h"
+#include "Stats.h"
+
+namespace
+{
+    /**
+     * Records the (wheel, prefix) states whose subtrees the DFS traversal has expanded.
+     * A prefix is identified by its length and word id, so a state reached again would search an identical subtree.
+     */
+    class ExpansionMemo
+    {
+      public:
+        explicit ExpansionMemo(bool isEnabled) : isEnabled(isEnabled) {}
+
+        /**
+         * Gets the status to advance the traversal with. A status that would expand a state already expanded
+         * becomes the equivalent status that does not, so the traversal moves on to the next letter instead.
+         */
+        Dictionary::SEARCH_STATUS filter(Dictionary::SEARCH_STATUS state, size_t wheel, const FlatDictionary::Cursor& cursor)
+        {
+            if(!isEnabled || (state != Dictionary::HIT_PARENT && state != Dictionary::MISS_PARENT))
+            {
+                return state;
+            }
+
+            if(expanded.insert({ wheel, cursor.depth(), cursor.getWordId() }).second)
+            {
+                return state;
+            }
+
+            return state == Dictionary::HIT_PARENT ? Dictionary::HIT_TERMINAL : Dictionary::MISS;
+        }
+
+        void clear(void)
+        {
+            expanded.clear();
+        }
+
+      private:
+        // A wheel, and the length and word id of the prefix whose final letter it supplied.
+        struct State
+        {
+            size_t wheel;
+            size_t depth;
+            FlatDictionary::WordId id;
+
+            bool operator==(const State& other) const
+            {
+                return wheel == other.wheel && depth == other.depth && id == other.id;
+            }
+        };
+
+        struct StateHash
+        {
+            size_t operator()(const State& state) const
+            {
+                return std::hash<uint64_t>()((static_cast<uint64_t>(state.wheel * 131 + state.depth) << 32) ^ state.id);
+            }
+        };
+
+        const bool isEnabled;
+        std::unordered_set<State, StateHash> expanded;
+    };
+
+    /**
+     * Finds every word continuing the prefix at the given node with a letter from the given wheel onwards,
+     * visiting only the letters both on the wheel and under the node.
+     * 
+     * @param wheels: the lettered wheels being searched
+     * @param dictionary: the dictionary being searched
+     * @param node: the node of the current prefix
+     * @param id: the word id of the current prefix
+     * @param wheel: the wheel supplying the next letter
+     * @param length: the number of letters in the current prefix
+     * @param found: receives each word found
+     * @param counters: receives the search counters, or nullptr to not count
+     */
+    void intersect(const Wheels& wheels, const FlatDictionary& dictionary, FlatDictionary::NodeId node,
+        FlatDictionary::WordId id, size_t wheel, size_t length, WordSet& found, [[maybe_unused]] Stats::Counters* counters)
+    {
+        uint32_t letters = wheels.getWheelMask(wheel) & dictionary.getChildMask(node);
+        const bool hasNextWheel = wheel + 1 < wheels.getNumberOfWheels();
+
+        // Visits each set bit, lowest letter first, clearing it once visited.
+        for(; letters != 0; letters &= letters - 1)
+        {
+            const unsigned char letter = static_cast<unsigned char>(std::countr_zero(letters));
+            FlatDictionary::WordId childId = id;
+            const FlatDictionary::NodeId child = dictionary.getChild(node, letter, childId);
+
+            // Words are at least two letters long.
+            if(length > 0 && dictionary.getIsWord(child))
+            {
+                found.insert(childId);
+            }
+
+            // Counts the prefixes a DFS would have looked up, from two letters long.
+            LW_STAT(if(counters != nullptr && length > 0)
+            {
+                const Dictionary::SEARCH_STATUS state = dictionary.getStatus(child);
+
+                counters->count(wheel - length, length + 1, state);
+            })
+
+            if(hasNextWheel)
+            {
+                intersect(wheels, dictionary, child, childId, wheel + 1, length + 1, found, counters);
+            }
+        }
+    }
+
+    /**
+     * For each letter, the set of wheels offering it, shared by every worker of the multi-start engine.
+     * Bit w % 64 of word w / 64 of a letter's row is set if wheel w offers the letter.
+     */
+    struct LetterWheels
+    {
+        explicit LetterWheels(const Wheels& wheels)
+            : wheelCount(wheels.getNumberOfWheels()), blocks((wheelCount + 63) / 64), stride(2 * blocks + 1),
+            rows(Utils::LETTERS_IN_ALPHABET * stride, 0)
+        {
+            for(size_t wheel = 0; wheel < wheelCount; wheel++)
+            {
+                for(uint32_t letters = wheels.getWheelMask(wheel); letters != 0; letters &= letters - 1)
+                {
+                    rows[std::countr_zero(letters) * stride + wheel / 64] |= uint64_t(1) << (wheel % 64);
+                }
+            }
+        }
+
+        const uint64_t* row(unsigned char letter) const
+        {
+            return rows.data() + letter * stride;
+        }
+
+        const size_t wheelCount;
+        // The number of words in a set of wheels.
+        const size_t blocks;
+        // Rows are padded with zero words, so a row read from any offset below the number of wheels stays in the row.
+        const size_t stride;
+        std::vector<uint64_t> rows;
+    };
+
+    /**
+     * Walks the dictionary once for every start wheel at the same time.
+     * 
+     * Each prefix on the walk carries the set of start wheels s from which it can be formed. The prefix extended
+     * by a letter can be formed from the starts in that set whose wheel s + length offers the letter, found by ANDing
+     * the set with the letter's wheels shifted down by the prefix length. A prefix no start can form is not extended.
+     */
+    class MultiStartWalk
+    {
+      public:
+        MultiStartWalk(const LetterWheels& letterWheels, const FlatDictionary& dictionary, WordSet& found,
+            Stats::Counters* counters)
+            : letterWheels(letterWheels), dictionary(dictionary), found(found), counters(counters) {}
+
+        /**
+         * Finds every word beginning with a letter.
+         * 
+         * @param letter: the index of the first letter in the alphabet
+         */
+        void walk(unsigned char letter)
+        {
+            const size_t blocks = letterWheels.blocks;
+            const size_t wheelCount = letterWheels.wheelCount;
+
+            // Every wheel but the final one can start a word.
+            starts.assign(2 * blocks, 0);
+            ranges.assign(2, { 0, 0 });
+
+            for(size_t wheel = 0; wheel + 1 < wheelCount; wheel++)
+            {
+                starts[wheel / 64] |= uint64_t(1) << (wheel % 64);
+            }
+
+            ranges[0] = { 0, blocks };
+
+            FlatDictionary::WordId id = 0;
+            const FlatDictionary::NodeId node = dictionary.getChild(FlatDictionary::ROOT, letter, id);
+
+            if(node != FlatDictionary::NO_NODE && extend(0, letter))
+            {
+                descend(node, id, 1);
+            }
+        }
+
+      private:
+        /**
+         * Computes the starts of the prefix at a depth extended by a letter, as the starts of the next depth.
+         * 
+         * @param length: the number of letters in the prefix
+         * @param letter: the index of the letter extending the prefix
+         * @return true if any start can form the extended prefix, else false
+         */
+        bool extend(size_t length, unsigned char letter)
+        {
+            const size_t blocks = letterWheels.blocks;
+            const uint64_t* const wheels = letterWheels.row(letter) + length / 64;
+            const unsigned shift = length % 64;
+            const uint64_t* const parent = starts.data() + length * blocks;
+            uint64_t* const child = starts.data() + (length + 1) * blocks;
+            const auto [begin, end] = ranges[length];
+            uint64_t remaining = 0;
+
+            // Plain loops over whole words, which the compiler is free to vectorize.
+            if(shift == 0)
+            {
+                for(size_t block = begin; block < end; block++)
+                {
+                    child[block] = parent[block] & wheels[block];
+                    remaining |= child[block];
+                }
+            }
+            else
+            {
+                for(size_t block = begin; block < end; block++)
+                {
+                    child[block] = parent[block] & ((wheels[block] >> shift) | (wheels[block + 1] << (64 - shift)));
+                    remaining |= child[block];
+                }
+            }
+
+            if(remaining == 0)
+            {
+                return false;
+            }
+
+            // Narrows the range of words holding a start, which only shrinks as the prefix grows.
+            size_t first = begin;
+            size_t last = end;
+
+            while(child[first] == 0)
+            {
+                first++;
+            }
+
+            while(child[last - 1] == 0)
+            {
+                last--;
+            }
+
+            ranges[length + 1] = { first, last };
+
+            return true;
+        }
+
+        /**
+         * Finds every word continuing the prefix at a node, whose starts are those of its depth.
+         * 
+         * @param node: the node of the prefix
+         * @param id: the word id of the prefix
+         * @param length: the number of letters in the prefix
+         */
+        void descend(FlatDictionary::NodeId node, FlatDictionary::WordId id, size_t length)
+        {
+            // The sets of the next depth are allocated the first time the walk reaches it.
+            if(ranges.size() < length + 2)
+            {
+                starts.resize((length + 2) * letterWheels.blocks, 0);
+                ranges.resize(length + 2, { 0, 0 });
+            }
+
+            for(uint32_t letters = dictionary.getChildMask(node); letters != 0; letters &= letters - 1)
+            {
+                const unsigned char letter = static_cast<unsigned char>(std::countr_zero(letters));
+
+                if(!extend(length, letter))
+                {
+                    continue;
+                }
+
+                FlatDictionary::WordId childId = id;
+                const FlatDictionary::NodeId child = dictionary.getChild(node, letter, childId);
+
+                // Words are at least two letters long, which every prefix past the first letter is.
+                if(dictionary.getIsWord(child))
+                {
+                    found.insert(childId);
+                }
+
+                LW_STAT(if(counters != nullptr)
+                {
+                    count(child, length + 1);
+                })
+
+                descend(child, childId, length + 1);
+            }
+        }
+
+        // Counts the prefix at a node once for every start wheel it can be formed from, as the bitmask engine would visit it.
+        void count(FlatDictionary::NodeId node, size_t length)
+        {
+            const Dictionary::SEARCH_STATUS state = dictionary.getStatus(node);
+            const uint64_t* const set = starts.data() + length * letterWheels.blocks;
+
+            for(size_t block = ranges[length].first; block < ranges[length].second; block++)
+            {
+                for(uint64_t bits = set[block]; bits != 0; bits &= bits - 1)
+                {
+                    counters->count(block * 64 + std::countr_zero(bits), length, state);
+                }
+            }
+        }
+
+        const LetterWheels& letterWheels;
+        const FlatDictionary& dictionary;
+        WordSet& found;
+        [[maybe_unused]] Stats::Counters* counters;
+        // The start wheels of the prefix at each depth, one set of letterWheels.blocks words per depth.
+        std::vector<uint64_t> starts;
+        // The range of words of each depth's set that may hold a start.
+        std::vector<std::pair<size_t, size_t>> ranges;
+    };
+
+    /**
+     * Finds the words of a ranked query, abandoning every prefix that cannot reach the length of the shortest word
+     * still wanted.
+     * 
+     * For a query keeping the K longest words, the length wanted rises to that of the K-th longest unique word
+     * the walk has found, as no shorter word can displace it. Each worker's length is a lower bound of the final
+     * K-th length, so the greatest of them is shared between the workers.
+     */
+    class RankedWalk
+    {
+      public:
+        /**
+         * Constructor.
+         * 
+         * @param keep: the number of longest words kept, 1 if only the longest are, or 0 to keep every word long enough
+         * @param minimumLength: the number of letters in the shortest word wanted
+         * @param sharedLength: the length wanted by any worker, raised as the walk finds words
+         */
+        RankedWalk(const Wheels& wheels, const FlatDictionary& dictionary, size_t keep, size_t minimumLength,
+            std::atomic<size_t>& sharedLength, WordSet& found, Stats::Counters* counters)
+            : wheels(wheels), dictionary(dictionary), keep(keep), sharedLength(sharedLength), found(found),
+            counters(counters), wantedLength(minimumLength) {}
+
+        /**
+         * Finds the wanted words whose first letter is supplied by a wheel.
+         * 
+         * @param wheel: the index of the start wheel
+         * @param letter: the index of the first letter in the alphabet
+         */
+        void walk(size_t wheel, unsigned char letter)
+        {
+            FlatDictionary::WordId id = 0;
+            const FlatDictionary::NodeId node = dictionary.getChild(FlatDictionary::ROOT, letter, id);
+
+            if(canReach(node, wheel, 1))
+            {
+                descend(node, id, wheel + 1, 1);
+            }
+        }
+
+      private:
+        // Determines whether the prefix at a node, whose final letter a wheel supplied, can grow into a wanted word.
+        bool canReach(FlatDictionary::NodeId node, size_t wheel, size_t length) const
+        {
+            const size_t wheelsLeft = wheels.getNumberOfWheels() - wheel - 1;
+            const size_t longest = length + std::min(dictionary.getHeight(node), wheelsLeft);
+
+            return longest >= std::max(wantedLength, sharedLength.load(std::memory_order_relaxed));
+        }
+
+        /**
+         * Finds the wanted words continuing the prefix at a node with a letter from a wheel onwards.
+         * 
+         * @param node: the node of the prefix
+         * @param id: the word id of the prefix
+         * @param wheel: the wheel supplying the next letter
+         * @param length: the number of letters in the prefix
+         */
+        void descend(FlatDictionary::NodeId node, FlatDictionary::WordId id, size_t wheel, size_t length)
+        {
+            for(uint32_t letters = wheels.getWheelMask(wheel) & dictionary.getChildMask(node); letters != 0; letters &= letters - 1)
+            {
+                const unsigned char letter = static_cast<unsigned char>(std::countr_zero(letters));
+                FlatDictionary::WordId childId = id;
+                const FlatDictionary::NodeId child = dictionary.getChild(node, letter, childId);
+
+                // The child's word and every continuation of it are too short to be wanted.
+                if(!canReach(child, wheel, length + 1))
+                {
+                    continue;
+                }
+
+                LW_STAT(if(counters != nullptr)
+                {
+                    const Dictionary::SEARCH_STATUS state = dictionary.getStatus(child);
+
+                    counters->count(wheel - length, length + 1, state);
+                })
+
+                if(dictionary.getIsWord(child) && length + 1 >= wantedLength)
+                {
+                    record(childId, length + 1);
+                }
+
+                if(wheel + 1 < wheels.getNumberOfWheels())
+                {
+                    descend(child, childId, wheel + 1, length + 1);
+                }
+            }
+        }
+
+        // Adds a word to those found and, if it was not found before, raises the length wanted once K longer words are known.
+        void record(FlatDictionary::WordId id, size_t length)
+        {
+            if(!found.insert(id) || keep == 0)
+            {
+                return;
+            }
+
+            if(lengthCounts.size() <= length)
+            {
+                lengthCounts.resize(length + 1, 0);
+            }
+
+            lengthCounts[length]++;
+            wordsWanted++;
+
+            // Words of the length wanted are no longer needed once K words are longer.
+            while(wordsWanted - lengthCounts[wantedLength] >= keep)
+            {
+                wordsWanted -= lengthCounts[wantedLength];
+                wantedLength++;
+            }
+
+            for(size_t shared = sharedLength.load(std::memory_order_relaxed);
+                shared < wantedLength && !sharedLength.compare_exchange_weak(shared, wantedLength, std::memory_order_relaxed);)
+            {
+            }
+        }
+
+        const Wheels& wheels;
+        const FlatDictionary& dictionary;
+        const size_t keep;
+        std::atomic<size_t>& sharedLength;
+        WordSet& found;
+        [[maybe_unused]] Stats::Counters* counters;
+        // The number of letters in the shortest word this worker still wants.
+        size_t wantedLength;
+        // The number of unique words of each length found since that length was wanted.
+        std::vector<size_t> lengthCounts;
+        // The number of unique words found of at least the length wanted.
+        size_t wordsWanted = 0;
+    };
+}
+
+WordSet Search::sequential(Wheels& wheels, const FlatDictionary& dictionary, bool memoize,
+    [[maybe_unused]] Stats::Counters* counters)
+{
+    // The collection of unique words generated from the lettered wheels, and found in the dictionary.
+    WordSet result(dictionary);
+    // Tracks the current permutation in the dictionary, so each step of the search costs a single child lookup.
+    FlatDictionary::Cursor cursor(dictionary);
+    ExpansionMemo memo(memoize);
+
+    for(char letter : wheels.getCurrentPermutation())
+    {
+        cursor.descend(letter);
+    }
+
+    while(wheels.canPermute())
+    {
+        // The search status of the current permutation in the dictionary.
+        Dictionary::SEARCH_STATUS state = cursor.status();
+
+        LW_STAT(if(counters != nullptr)
+        {
+            counters->count(wheels.getEndWheelIndex() + 1 - cursor.depth(), cursor.depth(), state);
+        })
+
+        // The word has been found, so add it to the result set. A word found before costs a single bit test.
+        if(state == Dictionary::HIT_PARENT || state == Dictionary::HIT_TERMINAL)
+        {
+            result.insert(cursor.getWordId());
+        }
+
+        // Generate a new word to attempt to find, moving the cursor along with it.
+        wheels.advancePermutation(memo.filter(state, wheels.getEndWheelIndex(), cursor), cursor);
+    }
+
+    return result;
+}
+
+WordSet Search::parallel(const Wheels& wheels, const FlatDictionary& dictionary, size_t threads,
+    bool memoize, [[maybe_unused]] Stats::Counters* counters)
+{
+    const size_t lettersPerWheel = wheels.getLettersPerWheel();
+    const size_t startingWheels = wheels.getNumberOfWheels() - 1;
+    // One task per two letter prefix, numbered in the order the sequential traversal visits them.
+    const size_t taskCount = startingWheels * lettersPerWheel * lettersPerWheel;
+
+    WorkStealingPool pool(threads);
+
+    // Each worker advances its own copy of the wheels and its own cursor, and collects its own words.
+    std::vector<std::unique_ptr<Wheels>> workerWheels;
+    std::vector<std::unique_ptr<FlatDictionary::Cursor>> workerCursors;
+    std::vector<std::unique_ptr<ExpansionMemo>> workerMemos;
+    std::vector<WordSet> workerResults;
+    LW_STAT(std::vector<Stats::Counters> workerCounters(pool.getThreadCount());)
+
+    for(size_t i = 0; i < pool.getThreadCount(); i++)
+    {
+        workerWheels.push_back(std::make_unique<Wheels>(wheels));
+        workerCursors.push_back(std::make_unique<FlatDictionary::Cursor>(dictionary));
+        workerMemos.push_back(std::make_unique<ExpansionMemo>(memoize));
+        workerResults.emplace_back(dictionary);
+    }
+
+    pool.run(taskCount, [&](size_t worker, size_t task)
+    {
+        Wheels& subtree = *workerWheels[worker];
+        FlatDictionary::Cursor& cursor = *workerCursors[worker];
+        ExpansionMemo& memo = *workerMemos[worker];
+        WordSet& found = workerResults[worker];
+
+        // Tasks run in any order on any worker, so states are only shared within a subtree.
+        memo.clear();
+
+        subtree.restrictToSubtree(task / (lettersPerWheel * lettersPerWheel),
+            (task / lettersPerWheel) % lettersPerWheel, task % lettersPerWheel);
+        cursor.reset();
+
+        for(char letter : subtree.getCurrentPermutation())
+        {
+            cursor.descend(letter);
+        }
+
+        while(subtree.canPermute())
+        {
+            Dictionary::SEARCH_STATUS state = cursor.status();
+
+            LW_STAT(if(counters != nullptr)
+            {
+                workerCounters[worker].count(subtree.getEndWheelIndex() + 1 - cursor.depth(), cursor.depth(), state);
+            })
+
+            if(state == Dictionary::HIT_PARENT || state == Dictionary::HIT_TERMINAL)
+            {
+                found.insert(cursor.getWordId());
+            }
+
+            subtree.advancePermutation(memo.filter(state, subtree.getEndWheelIndex(), cursor), cursor);
+        }
+    });
+
+    // A word is in the result once whichever subtrees found it, so the merged collection matches the sequential one.
+    for(size_t i = 1; i < workerResults.size(); i++)
+    {
+        workerResults[0].merge(workerResults[i]);
+    }
+
+    LW_STAT(if(counters != nullptr)
+    {
+        for(const Stats::Counters& workerCounter : workerCounters)
+        {
+            counters->merge(workerCounter);
+        }
+    })
+
+    return std::move(workerResults[0]);
+}
+
+WordSet Search::bitmask(const Wheels& wheels, const FlatDictionary& dictionary, size_t threads,
+    [[maybe_unused]] Stats::Counters* counters)
+{
+    // A word needs a second wheel, so the final wheel never starts one.
+    const size_t startingWheels = wheels.getNumberOfWheels() - 1;
+    // One task per (start wheel, first letter) pair, numbered in start wheel then letter order.
+    const size_t taskCount = startingWheels * Utils::LETTERS_IN_ALPHABET;
+
+    WorkStealingPool pool(threads);
+    // Each worker collects its own words.
+    std::vector<WordSet> workerResults(pool.getThreadCount(), WordSet(dictionary));
+    std::vector<Stats::Counters> workerCounters(pool.getThreadCount());
+
+    pool.run(taskCount, [&](size_t worker, size_t task)
+    {
+        const size_t wheel = task / Utils::LETTERS_IN_ALPHABET;
+        const unsigned char letter = static_cast<unsigned char>(task % Utils::LETTERS_IN_ALPHABET);
+
+        if(!(wheels.getWheelMask(wheel) & dictionary.getChildMask(FlatDictionary::ROOT) & (1u << letter)))
+        {
+            return;
+        }
+
+        FlatDictionary::WordId id = 0;
+        const FlatDictionary::NodeId node = dictionary.getChild(FlatDictionary::ROOT, letter, id);
+
+        intersect(wheels, dictionary, node, id, wheel + 1, 1, workerResults[worker],
+            counters != nullptr ? &workerCounters[worker] : nullptr);
+    });
+
+    for(size_t i = 1; i < workerResults.size(); i++)
+    {
+        workerResults[0].merge(workerResults[i]);
+    }
+
+    LW_STAT(if(counters != nullptr)
+    {
+        for(const Stats::Counters& workerCounter : workerCounters)
+        {
+            counters->merge(workerCounter);
+        }
+    })
+
+    return std::move(workerResults[0]);
+}
+
+WordSet Search::multiStart(const Wheels& wheels, const FlatDictionary& dictionary, size_t threads,
+    [[maybe_unused]] Stats::Counters* counters)
+{
+    const LetterWheels letterWheels(wheels);
+
+    WorkStealingPool pool(threads);
+    // Each worker walks its own first letters, with its own sets of starts, and collects its own words.
+    std::vector<WordSet> workerResults(pool.getThreadCount(), WordSet(dictionary));
+    std::vector<Stats::Counters> workerCounters(pool.getThreadCount());
+    std::vector<std::unique_ptr<MultiStartWalk>> workerWalks;
+
+    for(size_t i = 0; i < pool.getThreadCount(); i++)
+    {
+        workerWalks.push_back(std::make_unique<MultiStartWalk>(letterWheels, dictionary, workerResults[i],
+            counters != nullptr ? &workerCounters[i] : nullptr));
+    }
+
+    // One task per first letter.
+    pool.run(Utils::LETTERS_IN_ALPHABET, [&](size_t worker, size_t task)
+    {
+        workerWalks[worker]->walk(static_cast<unsigned char>(task));
+    });
+
+    for(size_t i = 1; i < workerResults.size(); i++)
+    {
+        workerResults[0].merge(workerResults[i]);
+    }
+
+    LW_STAT(if(counters != nullptr)
+    {
+        for(const Stats::Counters& workerCounter : workerCounters)
+        {
+            counters->merge(workerCounter);
+        }
+    })
+
+    return std::move(workerResults[0]);
+}
+
+Generator<std::string_view> Search::generate(Wheels wheels, const FlatDictionary& dictionary, bool memoize,
+    [[maybe_unused]] Stats::Counters* counters)
+{
+    // The traversal, cursor and words found live in the coroutine frame between the words pulled.
+    WordSet found(dictionary);
+    FlatDictionary::Cursor cursor(dictionary);
+    ExpansionMemo memo(memoize);
+    std::string word;
+
+    for(char letter : wheels.getCurrentPermutation())
+    {
+        cursor.descend(letter);
+    }
+
+    while(wheels.canPermute())
+    {
+        const Dictionary::SEARCH_STATUS state = cursor.status();
+
+        LW_STAT(if(counters != nullptr)
+        {
+            counters->count(wheels.getEndWheelIndex() + 1 - cursor.depth(), cursor.depth(), state);
+        })
+
+        // Suspends at each new word until the next one is pulled.
+        if((state == Dictionary::HIT_PARENT || state == Dictionary::HIT_TERMINAL) && found.insert(cursor.getWordId()))
+        {
+            dictionary.getWord(cursor.getWordId(), word);
+            co_yield word;
+        }
+
+        wheels.advancePermutation(memo.filter(state, wheels.getEndWheelIndex(), cursor), cursor);
+    }
+}
+
+size_t Search::forEach(const Wheels& wheels, const FlatDictionary& dictionary,
+    const std::function<bool(std::string_view word)>& sink, bool memoize)
+{
+    size_t delivered = 0;
+
+    for(std::string_view word : generate(wheels, dictionary, memoize))
+    {
+        delivered++;
+
+        if(!sink(word))
+        {
+            break;
+        }
+    }
+
+    return delivered;
+}
+
+WordSet Search::ranked(const Wheels& wheels, const FlatDictionary& dictionary, const Utils::Options& options,
+    size_t threads, [[maybe_unused]] Stats::Counters* counters)
+{
+    // Words are at least two letters long. Only the longest are kept, ties included, by raising the length wanted
+    // as a top-1 query would.
+    const size_t minimumLength = std::max<size_t>(options.minimumLength, 2);
+    const size_t keep = options.longest ? 1 : options.topK;
+    const size_t startingWheels = wheels.getNumberOfWheels() - 1;
+    std::atomic<size_t> sharedLength(minimumLength);
+
+    WorkStealingPool pool(threads);
+    std::vector<WordSet> workerResults(pool.getThreadCount(), WordSet(dictionary));
+    std::vector<Stats::Counters> workerCounters(pool.getThreadCount());
+    std::vector<std::unique_ptr<RankedWalk>> workerWalks;
+
+    for(size_t i = 0; i < pool.getThreadCount(); i++)
+    {
+        workerWalks.push_back(std::make_unique<RankedWalk>(wheels, dictionary, keep, minimumLength, sharedLength,
+            workerResults[i], counters != nullptr ? &workerCounters[i] : nullptr));
+    }
+
+    // One task per (start wheel, first letter) pair, as bitmask() shares them out.
+    pool.run(startingWheels * Utils::LETTERS_IN_ALPHABET, [&](size_t worker, size_t task)
+    {
+        const size_t wheel = task / Utils::LETTERS_IN_ALPHABET;
+        const unsigned char letter = static_cast<unsigned char>(task % Utils::LETTERS_IN_ALPHABET);
+
+        if(wheels.getWheelMask(wheel) & dictionary.getChildMask(FlatDictionary::ROOT) & (1u << letter))
+        {
+            workerWalks[worker]->walk(wheel, letter);
+        }
+    });
+
+    for(size_t i = 1; i < workerResults.size(); i++)
+    {
+        workerResults[0].merge(workerResults[i]);
+    }
+
+    LW_STAT(if(counters != nullptr)
+    {
+        for(const Stats::Counters& workerCounter : workerCounters)
+        {
+            counters->merge(workerCounter);
+        }
+    })
+
+    if(keep == 0)
+    {
+        return std::move(workerResults[0]);
+    }
+
+    // Words found before the length wanted rose are among those found, so the words kept are chosen from them,
+    // longest first, then alphabetically.
+    std::vector<std::pair<std::string, FlatDictionary::WordId>> candidates;
+
+    for(FlatDictionary::WordId id : workerResults[0].getWordIds())
+    {
+        candidates.emplace_back(dictionary.getWord(id), id);
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b)
+    {
+        return a.first.size() != b.first.size() ? a.first.size() > b.first.size() : a.first < b.first;
+    });
+
+    WordSet result(dictionary);
+
+    for(size_t i = 0; i < candidates.size(); i++)
+    {
+        const bool isKept = options.longest ? candidates[i].first.size() == candidates[0].first.size() : i < keep;
+
+        if(!isKept)
+        {
+            break;
+        }
+
+        result.insert(candidates[i].second);
+    }
+
+    return result;
+}
+
+WordSet Search::solve(const Wheels& wheels, const FlatDictionary& dictionary,
+    const Utils::Options& options, size_t threads, Stats::Counters* counters)
+{
+    if(options.minimumLength > 0 || options.topK > 0 || options.longest)
+    {
+        return ranked(wheels, dictionary, options, threads, counters);
+    }
+
+    if(options.engine == Utils::Options::MULTI_START)
+    {
+        return multiStart(wheels, dictionary, threads, counters);
+    }
+
+    if(options.engine == Utils::Options::BITMASK)
+    {
+        return bitmask(wheels, dictionary, threads, counters);
+    }
+
+    if(threads == 1)
+    {
+        Wheels traversal(wheels);
+        return sequential(traversal, dictionary, options.memoize, counters);
+    }
+
+    return parallel(wheels, dictionary, threads, options.memoize, counters);
+}
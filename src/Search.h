@@ -0,0 +1,146 @@
+#pragma once
+
+#include <string_view>
+#include <functional>
+
+#include "Generator.h"
+#include "Wheels.h"
+#include "FlatDictionary.h"
+#include "WordSet.h"
+#include "Stats.h"
+#include "Utils.h"
+
+/// The strategies used to find every dictionary word formed by a series of lettered wheels.
+class Search
+{
+  public:
+    /**
+     * Finds every word formed by the wheels with a single DFS traversal on the calling thread.
+     * 
+     * If memoize is true, each (wheel, prefix) state that continues a prefix is recorded when first expanded.
+     * Reaching the same prefix at the same wheel again, through a letter repeated on a wheel, would search an
+     * identical subtree. Such subtrees are skipped. Every word they hold was
+     * already found, so the returned collection is unchanged.
+     * 
+     * @param wheels: the lettered wheels to search. The traversal is consumed by the search.
+     * @param dictionary: the dictionary to cross-reference the permutations with
+     * @param memoize: true to skip repeated (wheel, prefix) states
+     * @param counters: receives the search counters, or nullptr to not count. Ignored if the counters are compiled out.
+     * @return the collection of unique words formed by the wheels and present in the dictionary
+     */
+    static WordSet sequential(Wheels& wheels, const FlatDictionary& dictionary, bool memoize = false,
+        Stats::Counters* counters = nullptr);
+    /**
+     * Finds every word formed by the wheels, sharing the DFS traversal between a number of threads.
+     * 
+     * Every two letter prefix (a starting letter and a letter on the following wheel) roots an independent
+     * subtree of the traversal. The subtrees are handed to a work stealing pool, so the deep subtrees of
+     * early wheels are spread across all threads. Each thread collects the words it finds, and the collections
+     * are merged once every subtree is searched, so the returned collection is identical to that of sequential().
+     * 
+     * @param wheels: the lettered wheels to search. The object is not modified.
+     * @param dictionary: the dictionary to cross-reference the permutations with
+     * @param threads: the number of threads to use. 0 selects the number of hardware threads.
+     * @param memoize: true to skip repeated (wheel, prefix) states within each subtree, see sequential()
+     * @param counters: receives the search counters, or nullptr to not count. Ignored if the counters are compiled out.
+     * @return the collection of unique words formed by the wheels and present in the dictionary
+     */
+    static WordSet parallel(const Wheels& wheels, const FlatDictionary& dictionary, size_t threads,
+        bool memoize = false, Stats::Counters* counters = nullptr);
+    /**
+     * Finds every word formed by the wheels by intersecting letter masks, rather than probing every letter in turn.
+     * 
+     * From each prefix, only the letters that are both on the next wheel and continue the prefix in the dictionary
+     * (the wheel's mask ANDed with the node's child mask) are visited, by iterating the set bits. No probe ends in a
+     * MISS, and a letter repeated on a wheel is visited once. The returned collection is identical to that of
+     * sequential().
+     * 
+     * @param wheels: the lettered wheels to search. The object is not modified.
+     * @param dictionary: the dictionary to cross-reference the permutations with
+     * @param threads: the number of threads to use, sharing out (start wheel, first letter) pairs. 0 selects the number of hardware threads.
+     * @param counters: receives the search counters, or nullptr to not count. Ignored if the counters are compiled out.
+     *   Only prefixes present in the dictionary are visited, so no lookup is counted as a MISS.
+     * @return the collection of unique words formed by the wheels and present in the dictionary
+     */
+    static WordSet bitmask(const Wheels& wheels, const FlatDictionary& dictionary, size_t threads,
+        Stats::Counters* counters = nullptr);
+    /**
+     * Finds every word formed by the wheels by walking the dictionary once for every start wheel at the same time,
+     * rather than once per start wheel.
+     * 
+     * Each prefix on the walk carries a bitset of the start wheels it can be formed from. Extending the prefix by a
+     * letter ANDs that bitset with the letter's wheels shifted down by the prefix length, so each dictionary node costs
+     * a few word-wide operations however many start wheels reach it. Suited to puzzles of hundreds of wheels, where
+     * the other engines repeat the same prefixes from every start wheel. The returned collection is identical to that of
+     * sequential().
+     * 
+     * @param wheels: the lettered wheels to search. The object is not modified.
+     * @param dictionary: the dictionary to cross-reference the permutations with
+     * @param threads: the number of threads to use, sharing out first letters. 0 selects the number of hardware threads.
+     * @param counters: receives the search counters, or nullptr to not count. Ignored if the counters are compiled out.
+     *   Each prefix is counted once per start wheel it can be formed from, as bitmask() would visit it.
+     * @return the collection of unique words formed by the wheels and present in the dictionary
+     */
+    static WordSet multiStart(const Wheels& wheels, const FlatDictionary& dictionary, size_t threads,
+        Stats::Counters* counters = nullptr);
+    /**
+     * Finds the words formed by the wheels lazily, for callers that may not need every word.
+     * 
+     * The DFS traversal held by the wheels only advances as words are pulled from the generator. Each unique word
+     * is yielded the first time it is found, in the order sequential() finds them. A caller that stops iterating,
+     * for instance after the first word of six letters, skips the rest of the traversal.
+     * 
+     * @param wheels: the lettered wheels to search. The generator traverses its own copy.
+     * @param dictionary: the dictionary to cross-reference the permutations with. It must outlive the generator.
+     * @param memoize: true to skip repeated (wheel, prefix) states, see sequential()
+     * @param counters: receives the counters of the lookups made up to the last word pulled, or nullptr to not count.
+     *   It must outlive the generator. Ignored if the counters are compiled out.
+     * @return a generator of the unique words found, in uppercase. Each view is invalidated when the generator is advanced.
+     */
+    static Generator<std::string_view> generate(Wheels wheels, const FlatDictionary& dictionary, bool memoize = false,
+        Stats::Counters* counters = nullptr);
+    /**
+     * Hands the words formed by the wheels to a callback as generate() finds them, until the callback asks to stop.
+     * 
+     * @param wheels: the lettered wheels to search. The object is not modified.
+     * @param dictionary: the dictionary to cross-reference the permutations with
+     * @param sink: called with each unique word found, in uppercase. Returns false to stop the search.
+     * The view is only valid during the call.
+     * @param memoize: true to skip repeated (wheel, prefix) states, see sequential()
+     * @return the number of words handed to the callback
+     */
+    static size_t forEach(const Wheels& wheels, const FlatDictionary& dictionary,
+        const std::function<bool(std::string_view word)>& sink, bool memoize = false);
+    /**
+     * Finds only the words wanted by a ranked query: those of at least options.minimumLength letters, and of those
+     * the options.topK longest, or every word of the greatest length if options.longest is set.
+     * 
+     * The traversal visits letters as bitmask() does, but abandons a prefix that cannot reach the length of the
+     * shortest word still wanted. A prefix can grow by no more than its node's height, the longest continuation in
+     * the dictionary, nor past the final wheel. The length wanted starts at the minimum length, and for a top-k
+     * query rises to that of the K-th longest word found so far, which the threads share, so a tight K skips most
+     * of the traversal. Of words of equal length, the alphabetically first are kept.
+     * 
+     * @param wheels: the lettered wheels to search. The object is not modified.
+     * @param dictionary: the dictionary to cross-reference the permutations with
+     * @param options: the options holding the query
+     * @param threads: the number of threads to use, sharing out (start wheel, first letter) pairs. 0 selects the number of hardware threads.
+     * @param counters: receives the search counters, or nullptr to not count. Ignored if the counters are compiled out.
+     * @return the collection of unique words formed by the wheels, present in the dictionary and wanted by the query
+     */
+    static WordSet ranked(const Wheels& wheels, const FlatDictionary& dictionary, const Utils::Options& options,
+        size_t threads, Stats::Counters* counters = nullptr);
+    /**
+     * Finds every word formed by the wheels with the engine and settings selected in the options.
+     * A ranked query (--min-length, --top-k or --longest) is answered by ranked(), whichever engine is selected.
+     * 
+     * @param wheels: the lettered wheels to search. The object is not modified.
+     * @param dictionary: the dictionary to cross-reference the permutations with
+     * @param options: the options selecting the search engine and its settings
+     * @param threads: the number of threads to use, in place of the thread count in the options. 0 selects the number of hardware threads.
+     * @param counters: receives the search counters, or nullptr to not count. Ignored if the counters are compiled out.
+     * @return the collection of unique words formed by the wheels and present in the dictionary, or those wanted by a ranked query
+     */
+    static WordSet solve(const Wheels& wheels, const FlatDictionary& dictionary,
+        const Utils::Options& options, size_t threads, Stats::Counters* counters = nullptr);
+};
@@ -0,0 +1,549 @@
+#include "Server.h"
+
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <filesystem>
+#include <algorithm>
+#include <stdexcept>
+#include <optional>
+#include <list>
+#include <iterator>
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#include "Wheels.h"
+#include "Search.h"
+#include "WordSet.h"
+#include "ResultWriter.h"
+#include "DictionaryHandle.h"
+#include "DictionaryLoader.h"
+#include "Utils.h"
+
+namespace
+{
+    // Bounds the size of a single request, so a malformed header cannot exhaust the server's memory.
+    const size_t MAXIMUM_REQUEST_WHEELS = 1 << 16;
+    const size_t MAXIMUM_REQUEST_LETTERS = 1 << 12;
+    // Bounds the number of connections served at once, each on its own thread. Further clients wait to be accepted.
+    const size_t MAXIMUM_CONNECTIONS = 64;
+
+    // Reads the number on a request header line, or returns false if the line is not a positive integer within the limit.
+    bool parseHeader(const std::string& line, size_t limit, size_t& value)
+    {
+        if(line.empty() || line.size() > 9 || line.find_first_not_of("0123456789") != std::string::npos)
+        {
+            return false;
+        }
+
+        value = std::stoull(line);
+
+        return value > 0 && value <= limit;
+    }
+
+    // Flattens a message onto a single line, for use in an error response.
+    std::string singleLine(std::string message)
+    {
+        for(char& c : message)
+        {
+            if(c == '\n' || c == '\r')
+            {
+                c = ' ';
+            }
+        }
+
+        return message;
+    }
+}
+
+std::string Server::respond(const FlatDictionary& dictionary, std::string_view request, const Utils::Options& options)
+{
+    std::istringstream stream{ std::string(request) };
+    std::string line;
+    size_t numberOfWheels = 0;
+    size_t lettersPerWheel = 0;
+
+    // The search indexes wheels by their declared proportions, so the request must match them exactly.
+    if(!std::getline(stream, line) || !parseHeader(line, MAXIMUM_REQUEST_WHEELS, numberOfWheels)
+        || !std::getline(stream, line) || !parseHeader(line, MAXIMUM_REQUEST_LETTERS, lettersPerWheel))
+    {
+        return "ERROR The request must start with the number of wheels and the number of letters per wheel"
+            " as positive integers, each on its own line.\n";
+    }
+
+    for(size_t i = 0; i < numberOfWheels; i++)
+    {
+        if(!std::getline(stream, line) || line.size() != lettersPerWheel)
+        {
+            return "ERROR The request must contain " + std::to_string(numberOfWheels) + " wheels of exactly "
+                + std::to_string(lettersPerWheel) + " letters.\n";
+        }
+    }
+
+    stream.clear();
+    stream.seekg(0);
+
+    std::optional<WordSet> result;
+
+    try
+    {
+        const Wheels wheels(stream);
+        result.emplace(Search::solve(wheels, dictionary, options, 1));
+    }
+    catch(const std::exception& e)
+    {
+        return "ERROR " + singleLine(e.what()) + "\n";
+    }
+
+    // The words follow in the order and format the CLI writes them in, ending with the count line.
+    std::ostringstream response;
+    response << "OK " << result->size() << "\n";
+    ResultWriter::write(*result, options, response);
+
+    return response.str();
+}
+
+void Server::watchDictionary(void)
+{
+    // The changed file is always built from text. An image provided with --index is rewritten for the next start.
+    Utils::Options reloadOptions = options;
+    reloadOptions.indexPath.clear();
+
+    // Waits of more than a day are cut short, as the deadline of a far longer wait would overflow the clock.
+    const std::chrono::seconds interval(std::min<size_t>(options.reloadSeconds, 24 * 60 * 60));
+    std::error_code error;
+    std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(options.dictionaryPath, error);
+    std::unique_lock<std::mutex> lock(watcherMutex);
+
+    while(!watcherWakeup.wait_for(lock, interval, [this] { return isStopping; }))
+    {
+        const std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(options.dictionaryPath, error);
+
+        // A file that is missing while it is replaced is checked again at the next interval.
+        if(error || writeTime == lastWriteTime)
+        {
+            continue;
+        }
+
+        lastWriteTime = writeTime;
+
+        // Requests are answered with the current dictionary while the new one is built, and the server can be stopped.
+        lock.unlock();
+
+        try
+        {
+            const auto start = std::chrono::steady_clock::now();
+            std::unique_ptr<FlatDictionary> reloaded = DictionaryLoader::load(reloadOptions, SIZE_MAX);
+
+            if(!options.indexPath.empty())
+            {
+                reloaded->save(options.indexPath);
+            }
+
+            dictionary.publish(std::move(reloaded));
+
+            std::cerr << "Reloaded the dictionary " << options.dictionaryPath << " in "
+                << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s." << std::endl;
+        }
+        catch(const std::exception& e)
+        {
+            std::cerr << e.what() << "\nKeeping the current dictionary." << std::endl;
+        }
+
+        lock.lock();
+    }
+}
+
+void Server::stopWatching(void)
+{
+    if(!watcher.joinable())
+    {
+        return;
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(watcherMutex);
+        isStopping = true;
+    }
+
+    watcherWakeup.notify_one();
+    watcher.join();
+}
+
+#ifdef _WIN32
+Server::Server(DictionaryHandle& dictionary, const std::string&, const Utils::Options& options) :
+    dictionary(dictionary), options(options)
+{
+    throw std::runtime_error("The solver server is not supported on Windows.");
+}
+
+Server::~Server(void) {}
+
+void Server::run(void) {}
+
+void Server::stop(void) {}
+
+void Server::reapConnections(std::unique_lock<std::mutex>&) {}
+
+void Server::serveConnection(int) const {}
+#else
+namespace
+{
+    // Reads lines from a connection through a buffer, so that pipelined requests are read with few system calls.
+    class LineReader
+    {
+      public:
+        explicit LineReader(int connection) : connection(connection) {}
+
+        // Reads the next line without its line ending, or returns false once the client has disconnected.
+        bool readLine(std::string& line)
+        {
+            while(true)
+            {
+                const size_t end = buffer.find('\n', position);
+
+                if(end != std::string::npos)
+                {
+                    line.assign(buffer, position, end - position);
+                    position = end + 1;
+
+                    if(!line.empty() && line.back() == '\r')
+                    {
+                        line.pop_back();
+                    }
+
+                    return true;
+                }
+
+                // Discards the lines already read before refilling the buffer.
+                buffer.erase(0, position);
+                position = 0;
+
+                char chunk[64 * 1024];
+                const ssize_t received = recv(connection, chunk, sizeof(chunk), 0);
+
+                if(received < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+
+                if(received <= 0)
+                {
+                    return false;
+                }
+
+                buffer.append(chunk, static_cast<size_t>(received));
+            }
+        }
+
+      private:
+        int connection;
+        std::string buffer;
+        size_t position = 0;
+    };
+
+    // Writes the whole of the data to the connection, or returns false if the client has disconnected.
+    bool writeAll(int connection, std::string_view data)
+    {
+        while(!data.empty())
+        {
+            const ssize_t sent = send(connection, data.data(), data.size(), MSG_NOSIGNAL);
+
+            if(sent < 0 && errno == EINTR)
+            {
+                continue;
+            }
+
+            if(sent <= 0)
+            {
+                return false;
+            }
+
+            data.remove_prefix(static_cast<size_t>(sent));
+        }
+
+        return true;
+    }
+}
+
+Server::Server(DictionaryHandle& dictionary, const std::string& address, const Utils::Options& options) :
+    dictionary(dictionary), options(options)
+{
+    if(address.rfind("unix:", 0) == 0)
+    {
+        socketPath = address.substr(5);
+        sockaddr_un socketAddress = {};
+
+        if(socketPath.empty() || socketPath.size() >= sizeof(socketAddress.sun_path))
+        {
+            throw std::invalid_argument("The Unix domain socket path is empty or too long: " + socketPath);
+        }
+
+        socketAddress.sun_family = AF_UNIX;
+        std::memcpy(socketAddress.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+        listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        // A socket file left behind by a previous server would prevent binding.
+        unlink(socketPath.c_str());
+
+        if(listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&socketAddress), sizeof(socketAddress)) != 0)
+        {
+            const std::string error = std::strerror(errno);
+
+            if(listener >= 0)
+            {
+                close(listener);
+            }
+
+            throw std::runtime_error("Unable to listen on the Unix domain socket " + socketPath + ": " + error);
+        }
+    }
+    else if(address.rfind("tcp:", 0) == 0)
+    {
+        size_t port = 0;
+
+        if(!parseHeader(address.substr(4), 65535, port))
+        {
+            throw std::invalid_argument("The TCP port must be in the range [1, 65535]. Value: " + address.substr(4));
+        }
+
+        sockaddr_in socketAddress = {};
+        socketAddress.sin_family = AF_INET;
+        socketAddress.sin_port = htons(static_cast<uint16_t>(port));
+        // Only local clients are served.
+        socketAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        const int enable = 1;
+
+        if(listener >= 0)
+        {
+            setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+        }
+
+        if(listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&socketAddress), sizeof(socketAddress)) != 0)
+        {
+            const std::string error = std::strerror(errno);
+
+            if(listener >= 0)
+            {
+                close(listener);
+            }
+
+            throw std::runtime_error("Unable to listen on TCP port " + std::to_string(port) + ": " + error);
+        }
+    }
+    else
+    {
+        throw std::invalid_argument("The server address must be unix:PATH or tcp:PORT. Value: " + address);
+    }
+
+    if(listen(listener, SOMAXCONN) != 0)
+    {
+        const std::string error = std::strerror(errno);
+        close(listener);
+        throw std::runtime_error("Unable to listen on " + address + ": " + error);
+    }
+}
+
+Server::~Server(void)
+{
+    stopWatching();
+    close(listener);
+
+    // Ends every connection still served, waking its thread from a read, then waits for the threads to finish.
+    {
+        const std::lock_guard<std::mutex> lock(connectionsMutex);
+
+        for(Connection& connection : connections)
+        {
+            shutdown(connection.socket, SHUT_RDWR);
+        }
+    }
+
+    for(Connection& connection : connections)
+    {
+        connection.thread.join();
+        close(connection.socket);
+    }
+
+    if(!socketPath.empty())
+    {
+        unlink(socketPath.c_str());
+    }
+}
+
+void Server::run(void)
+{
+    if(options.reloadSeconds > 0 && !watcher.joinable())
+    {
+        watcher = std::thread(&Server::watchDictionary, this);
+    }
+
+    while(true)
+    {
+        // Waits for a connection to finish before accepting another once the limit is reached.
+        {
+            std::unique_lock<std::mutex> lock(connectionsMutex);
+            connectionFinished.wait(lock, [this, &lock]
+            {
+                reapConnections(lock);
+                return connections.size() < MAXIMUM_CONNECTIONS || !isAccepting;
+            });
+
+            if(!isAccepting)
+            {
+                return;
+            }
+        }
+
+        const int connection = accept(listener, nullptr, nullptr);
+
+        if(connection < 0)
+        {
+            if(!isAccepting)
+            {
+                return;
+            }
+
+            // Interrupted calls and connections aborted before being accepted do not stop the server.
+            if(errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+
+            throw std::runtime_error(std::string("Unable to accept a connection: ") + std::strerror(errno));
+        }
+
+        const int enable = 1;
+        // Responses are written whole, so they should not wait to be coalesced with later data. Fails harmlessly on Unix sockets.
+        setsockopt(connection, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+        // The socket is closed once its thread is joined, so its descriptor is never reused while the server may shut it down.
+        const std::lock_guard<std::mutex> lock(connectionsMutex);
+        Connection& served = connections.emplace_back();
+        served.socket = connection;
+        served.thread = std::thread([this, &served]
+        {
+            serveConnection(served.socket);
+            // Ends the connection for the client now, though the descriptor stays open until the thread is reaped.
+            shutdown(served.socket, SHUT_RDWR);
+
+            const std::lock_guard<std::mutex> lock(connectionsMutex);
+            served.isFinished = true;
+            connectionFinished.notify_one();
+        });
+    }
+}
+
+void Server::stop(void)
+{
+    // Wakes run() if it is waiting for a connection to finish, or from accept(), which then fails.
+    {
+        const std::lock_guard<std::mutex> lock(connectionsMutex);
+        isAccepting = false;
+    }
+
+    connectionFinished.notify_one();
+    shutdown(listener, SHUT_RDWR);
+}
+
+void Server::reapConnections(std::unique_lock<std::mutex>& lock)
+{
+    std::list<Connection> finished;
+
+    for(auto it = connections.begin(); it != connections.end();)
+    {
+        const auto next = std::next(it);
+
+        if(it->isFinished)
+        {
+            finished.splice(finished.end(), connections, it);
+        }
+
+        it = next;
+    }
+
+    // A finished thread may still be releasing the lock, so it is joined without holding it.
+    lock.unlock();
+
+    for(Connection& connection : finished)
+    {
+        connection.thread.join();
+        close(connection.socket);
+    }
+
+    lock.lock();
+}
+
+void Server::serveConnection(int connection) const
+{
+    LineReader reader(connection);
+    std::string line;
+    std::string request;
+
+    while(reader.readLine(line))
+    {
+        // Tolerates blank lines between pipelined requests.
+        if(line.empty())
+        {
+            continue;
+        }
+
+        size_t numberOfWheels = 0;
+        size_t lettersPerWheel = 0;
+        request = line + "\n";
+
+        if(!parseHeader(line, MAXIMUM_REQUEST_WHEELS, numberOfWheels) || !reader.readLine(line)
+            || !parseHeader(line, MAXIMUM_REQUEST_LETTERS, lettersPerWheel))
+        {
+            writeAll(connection, "ERROR The request must start with the number of wheels and the number of letters per wheel"
+                " as positive integers, each on its own line.\n");
+            return;
+        }
+
+        request.append(line).push_back('\n');
+
+        bool isComplete = true;
+
+        for(size_t i = 0; i < numberOfWheels && isComplete; i++)
+        {
+            isComplete = reader.readLine(line);
+
+            if(isComplete)
+            {
+                request.append(line).push_back('\n');
+            }
+        }
+
+        // The client stopped sending before the end of the request, so it is answered with the wheels missing from it.
+        if(!isComplete)
+        {
+            writeAll(connection, respond(*dictionary.acquire(), request, options));
+            return;
+        }
+
+        // The request holds a snapshot of the dictionary until it is solved, so a reload never frees it mid-search.
+        const std::string response = respond(*dictionary.acquire(), request, options);
+
+        if(!writeAll(connection, response))
+        {
+            return;
+        }
+    }
+}
+#endif
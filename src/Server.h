@@ -0,0 +1,113 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <list>
+#include <atomic>
+
+#include "FlatDictionary.h"
+#include "DictionaryHandle.h"
+#include "Utils.h"
+
+/**
+ * A long-lived solver that answers lettered wheels puzzles sent over a local socket, against a dictionary
+ * that is loaded once.
+ * 
+ * The server listens on a Unix domain socket ("unix:PATH") or on a localhost TCP port ("tcp:PORT").
+ * Each connection is served on its own thread, sharing the read-only dictionary. At most 64 connections are served at
+ * once, and further clients wait to be accepted until one ends.
+ * 
+ * With --reload, the dictionary file is checked for changes in the background. A changed file is built into a new
+ * dictionary while requests are still answered, which is then swapped in. Each request is solved against the
+ * dictionary current when it arrived, so a request never sees a mix of the two.
+ * 
+ * A request is a puzzle in the wheels .txt format: the number of wheels and the number of letters per wheel,
+ * each on its own line, followed by one line of letters per wheel. Requests are self-delimiting, so a client may
+ * pipeline several requests on one connection; the responses are written in the order the requests were sent.
+ * 
+ * A response is "OK {count}" on its own line, followed by the output the CLI writes for the puzzle with the same options:
+ * each unique word found as --sort and --format select, unless --count-only is given, then the count line.
+ * A malformed request is answered with "ERROR {message}" on a single line. If the request's header could not be
+ * read, or the client stopped sending before the end of the request, the connection is closed after the error,
+ * as the following request cannot be located.
+ */
+class Server
+{
+  public:
+    /**
+     * Constructor. Starts listening on the given address.
+     * An existing file at the path of a Unix domain socket is replaced.
+     * 
+     * An exception will be thrown if the address is malformed or cannot be listened on.
+     * 
+     * @param dictionary: the dictionary to solve every request against, replaced when the dictionary file is reloaded.
+     * It must outlive the server.
+     * @param address: "unix:PATH" for a Unix domain socket, or "tcp:PORT" for a TCP port on 127.0.0.1
+     * @param options: the options selecting the search engine used to solve each request, and how the dictionary is reloaded
+     */
+    Server(DictionaryHandle& dictionary, const std::string& address, const Utils::Options& options);
+    ~Server(void);
+
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    /**
+     * Accepts and serves connections, and starts checking the dictionary file for changes if --reload was provided.
+     * Returns once stop() is called, or throws if the listening socket fails.
+     */
+    void run(void);
+    /**
+     * Stops accepting connections, so that run() returns. May be called from any thread.
+     * The connections already accepted are still served until the server is destroyed.
+     */
+    void stop(void);
+    /**
+     * Solves a single request.
+     * 
+     * @param dictionary: the dictionary to solve the request against
+     * @param request: a puzzle in the wheels .txt format, holding exactly the declared number of wheels and letters per wheel
+     * @param options: the options selecting the search engine used to solve the request
+     * @return the response to the request, see the class description
+     */
+    static std::string respond(const FlatDictionary& dictionary, std::string_view request, const Utils::Options& options);
+
+  private:
+    DictionaryHandle& dictionary;
+    const Utils::Options options;
+    std::string socketPath;
+    int listener = -1;
+    // Cleared by stop(), so that run() returns rather than throwing once accepting fails.
+    std::atomic<bool> isAccepting = true;
+    // The thread reloading the dictionary file, and the means of waking it to stop when the server is destroyed.
+    std::thread watcher;
+    std::mutex watcherMutex;
+    std::condition_variable watcherWakeup;
+    bool isStopping = false;
+
+    // A connection being served, by its own thread.
+    struct Connection
+    {
+        std::thread thread;
+        int socket = -1;
+        // Set by the thread once the client has disconnected, so the thread can be joined and the socket closed.
+        bool isFinished = false;
+    };
+
+    // The connections accepted and not yet reaped, guarded by connectionsMutex.
+    std::list<Connection> connections;
+    std::mutex connectionsMutex;
+    // Notified each time a connection is finished.
+    std::condition_variable connectionFinished;
+
+    // Serves the requests of a single connection until the client disconnects.
+    void serveConnection(int connection) const;
+    // Rebuilds and publishes the dictionary each time its file changes, until the server is destroyed.
+    void watchDictionary(void);
+    // Wakes the watcher thread and waits for it to stop.
+    void stopWatching(void);
+    // Joins the threads of finished connections and closes their sockets. Called with connectionsMutex held by the lock.
+    void reapConnections(std::unique_lock<std::mutex>& lock);
+};
@@ -0,0 +1,134 @@
+#include "Stats.h"
+
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <ostream>
+#include <algorithm>
+
+#include "Dictionary.h"
+#include "Utils.h"
+
+namespace
+{
+    // The names of the SEARCH_STATUS values, indexed by the status.
+    const char* const STATUS_NAMES[] = { "hit_terminal", "hit_parent", "miss_parent", "miss" };
+}
+
+void Stats::Counters::merge(const Counters& other)
+{
+    candidates += other.candidates;
+
+    for(size_t i = 0; i < probes.size(); i++)
+    {
+        probes[i] += other.probes[i];
+    }
+
+    if(depths.size() < other.depths.size())
+    {
+        depths.resize(other.depths.size());
+    }
+
+    for(size_t wheel = 0; wheel < other.depths.size(); wheel++)
+    {
+        if(depths[wheel].size() < other.depths[wheel].size())
+        {
+            depths[wheel].resize(other.depths[wheel].size(), 0);
+        }
+
+        for(size_t length = 0; length < other.depths[wheel].size(); length++)
+        {
+            depths[wheel][length] += other.depths[wheel][length];
+        }
+    }
+}
+
+void Stats::write(Utils::Options::FORMAT format, std::ostream& stream) const
+{
+    if(format == Utils::Options::JSON_LINES)
+    {
+        stream << "{\"wheel_parse_s\":" << wheelParseSeconds << ",\"dictionary_build_s\":" << dictionaryBuildSeconds
+            << ",\"search_s\":" << searchSeconds << ",\"output_s\":" << outputSeconds
+            << ",\"dictionary_layout\":\"" << dictionaryLayout << "\",\"dictionary_nodes\":" << dictionaryNodes
+            << ",\"dictionary_bytes\":" << dictionaryBytes << ",\"words_found\":" << wordsFound
+            << ",\"counters\":" << (isEnabled() ? "true" : "false");
+
+        if(isEnabled())
+        {
+            stream << ",\"candidates\":" << counters.candidates << ",\"probes\":{";
+
+            for(size_t i = 0; i < counters.probes.size(); i++)
+            {
+                stream << (i > 0 ? "," : "") << "\"" << STATUS_NAMES[i] << "\":" << counters.probes[i];
+            }
+
+            // One array per start wheel, counting the permutations of each length from 0.
+            stream << "},\"depths\":[";
+
+            for(size_t wheel = 0; wheel < counters.depths.size(); wheel++)
+            {
+                stream << (wheel > 0 ? ",[" : "[");
+
+                for(size_t length = 0; length < counters.depths[wheel].size(); length++)
+                {
+                    stream << (length > 0 ? "," : "") << counters.depths[wheel][length];
+                }
+
+                stream << "]";
+            }
+
+            stream << "]";
+        }
+
+        stream << "}" << std::endl;
+        return;
+    }
+
+    stream << "Wheel parse:      " << wheelParseSeconds << " s\n"
+        << "Dictionary build: " << dictionaryBuildSeconds << " s\n"
+        << "Search:           " << searchSeconds << " s\n"
+        << "Output:           " << outputSeconds << " s\n"
+        << "Dictionary:       " << dictionaryLayout << ", " << dictionaryNodes << " nodes, " << dictionaryBytes << " bytes\n"
+        << "Words found:      " << wordsFound << "\n";
+
+    if(!isEnabled())
+    {
+        stream << "Search counters:  compiled out (configure with -DLW_STATS=ON)" << std::endl;
+        return;
+    }
+
+    stream << "Candidates:       " << counters.candidates << "\n";
+
+    for(size_t i = 0; i < counters.probes.size(); i++)
+    {
+        stream << "  " << STATUS_NAMES[i] << std::string(14 - std::string(STATUS_NAMES[i]).size(), ' ')
+            << counters.probes[i] << "\n";
+    }
+
+    // A puzzle degenerates when its permutations keep reaching deep into the wheels.
+    stream << "Permutations by start wheel and length:\n";
+
+    for(size_t wheel = 0; wheel < counters.depths.size(); wheel++)
+    {
+        const std::vector<uint64_t>& lengths = counters.depths[wheel];
+
+        if(std::all_of(lengths.begin(), lengths.end(), [](uint64_t count) { return count == 0; }))
+        {
+            continue;
+        }
+
+        stream << "  wheel " << wheel << ":";
+
+        for(size_t length = 0; length < lengths.size(); length++)
+        {
+            if(lengths[length] > 0)
+            {
+                stream << " " << length << "=" << lengths[length];
+            }
+        }
+
+        stream << "\n";
+    }
+
+    stream.flush();
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <string>
+#include <ostream>
+
+#include "Dictionary.h"
+#include "Utils.h"
+
+/*
+ * The search counters are only compiled in when LW_STATS is defined (the CMake option of the same name).
+ * Otherwise LW_STAT() discards its statement, so the hot paths carry no counting at all.
+ * 
+ * Lookups are counted by the search engines, where each one is made, rather than in FlatDictionary::find() or
+ * FlatDictionary::Cursor::descend(). The bitmask engines step through the nodes without either, and only the engine
+ * knows the start wheel a lookup belongs to.
+ */
+#ifdef LW_STATS
+#define LW_STAT(statement) statement
+#else
+#define LW_STAT(statement)
+#endif
+
+/**
+ * The counters gathered by a search and the measurements of a solve, reported with --stats.
+ */
+class Stats
+{
+  public:
+    /// The counters gathered by a search. Each search thread fills its own, and they are merged once it ends.
+    struct Counters
+    {
+        /// The number of permutations of the wheels generated and looked up in the dictionary.
+        uint64_t candidates = 0;
+        /// The number of lookups ending in each SEARCH_STATUS, indexed by the status.
+        std::array<uint64_t, 4> probes = {};
+        /// For each start wheel, the number of permutations generated of each length.
+        std::vector<std::vector<uint64_t>> depths;
+
+        /**
+         * Counts a permutation and the status of its lookup.
+         * 
+         * @param startWheel: the index of the wheel supplying the first letter of the permutation
+         * @param length: the number of letters in the permutation
+         * @param state: the search status of the permutation
+         */
+        void count(size_t startWheel, size_t length, Dictionary::SEARCH_STATUS state)
+        {
+            candidates++;
+            probes[state]++;
+
+            if(depths.size() <= startWheel)
+            {
+                depths.resize(startWheel + 1);
+            }
+
+            if(depths[startWheel].size() <= length)
+            {
+                depths[startWheel].resize(length + 1, 0);
+            }
+
+            depths[startWheel][length]++;
+        }
+
+        /**
+         * Adds the counters of another search.
+         * 
+         * @param other: the counters to add
+         */
+        void merge(const Counters& other);
+    };
+
+    /// The wall time, in seconds, spent on each phase of a solve.
+    double wheelParseSeconds = 0;
+    double dictionaryBuildSeconds = 0;
+    double searchSeconds = 0;
+    double outputSeconds = 0;
+    /// The size of the dictionary searched.
+    size_t dictionaryNodes = 0;
+    size_t dictionaryBytes = 0;
+    std::string dictionaryLayout;
+    /// The number of words found.
+    size_t wordsFound = 0;
+    /// The search counters, left empty if they were compiled out.
+    Counters counters;
+
+    /**
+     * Writes the report as text, or as a single JSON object on one line.
+     * 
+     * @param format: TEXT for a readable report, or JSON_LINES for a JSON object
+     * @param stream: the stream to write to
+     */
+    void write(Utils::Options::FORMAT format, std::ostream& stream) const;
+    /**
+     * Determines whether the search counters were compiled in.
+     * 
+     * @return true if the build defines LW_STATS, else false
+     */
+    static constexpr bool isEnabled(void)
+    {
+#ifdef LW_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+};
@@ -0,0 +1,154 @@
+#include "Streaming.h"
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+
+#include "Wheels.h"
+#include "FlatDictionary.h"
+#include "ResultWriter.h"
+#include "WordSet.h"
+#include "Stats.h"
+#include "Utils.h"
+
+namespace
+{
+    /// Searches the window of wheel masks held while the wheels file is read.
+    class WindowSearch
+    {
+      public:
+        WindowSearch(const FlatDictionary& dictionary, const std::vector<uint32_t>& window, WordSet& found,
+            ResultWriter& writer, const Utils::Options& options, Stats::Counters* counters)
+            : dictionary(dictionary), window(window), found(found), writer(writer), options(options), counters(counters) {}
+
+        /**
+         * Finds the words starting at a wheel and writes those not found before.
+         *
+         * @param startWheel: the index of the wheel supplying the first letter
+         * @param wheels: the number of wheels from the start wheel onwards that have been read, at most the window size
+         * @return true if a word not found before was found, else false
+         */
+        bool search(size_t startWheel, size_t wheels)
+        {
+            this->startWheel = startWheel;
+            this->wheels = wheels;
+            hasFoundNew = false;
+
+            intersect(FlatDictionary::ROOT, 0, 0);
+
+            return hasFoundNew;
+        }
+
+      private:
+        /**
+         * Finds every word continuing the prefix at the given node with letters from the given wheel onwards,
+         * visiting only the letters both on the wheel and under the node, as Search::bitmask() does.
+         *
+         * @param node: the node of the current prefix
+         * @param id: the word id of the current prefix
+         * @param length: the number of letters in the current prefix, which is also the offset of the next wheel from the start wheel
+         */
+        void intersect(FlatDictionary::NodeId node, FlatDictionary::WordId id, size_t length)
+        {
+            uint32_t letters = window[(startWheel + length) % window.size()] & dictionary.getChildMask(node);
+
+            for(; letters != 0; letters &= letters - 1)
+            {
+                const unsigned char letter = static_cast<unsigned char>(std::countr_zero(letters));
+                FlatDictionary::WordId childId = id;
+                const FlatDictionary::NodeId child = dictionary.getChild(node, letter, childId);
+
+                // Words are at least two letters long. A word is only spelled the first time it is found.
+                if(length > 0 && dictionary.getIsWord(child) && found.insert(childId))
+                {
+                    hasFoundNew = true;
+
+                    if(!options.countOnly)
+                    {
+                        dictionary.getWord(childId, word);
+                        writer.appendWord(word, options.format);
+                    }
+                }
+
+                LW_STAT(if(counters != nullptr && length > 0)
+                {
+                    const Dictionary::SEARCH_STATUS state = dictionary.getStatus(child);
+
+                    counters->count(startWheel, length + 1, state);
+                })
+
+                if(length + 1 < wheels)
+                {
+                    intersect(child, childId, length + 1);
+                }
+            }
+        }
+
+        const FlatDictionary& dictionary;
+        // The masks of the wheels held, the wheel at index i in position i % window.size().
+        const std::vector<uint32_t>& window;
+        WordSet& found;
+        ResultWriter& writer;
+        const Utils::Options& options;
+        [[maybe_unused]] Stats::Counters* counters;
+        size_t startWheel = 0;
+        size_t wheels = 0;
+        bool hasFoundNew = false;
+        // Reused to spell every word written, so nothing is allocated per word.
+        std::string word;
+    };
+}
+
+size_t Streaming::solve(std::istream& wheelsFile, const FlatDictionary& dictionary, const Utils::Options& options,
+    std::ostream& stream, Stats::Counters* counters)
+{
+    const Wheels::Header header = Wheels::readHeader(wheelsFile);
+
+    // A word needs two wheels, and never spans more wheels than the longest word has letters.
+    std::vector<uint32_t> window(std::max<size_t>(dictionary.getLongestWordSize(), 2), 0);
+    WordSet found(dictionary);
+    ResultWriter writer(stream);
+    WindowSearch search(dictionary, window, found, writer, options, counters);
+    std::string line;
+    size_t wheelsRead = 0;
+
+    // Only the declared number of wheels is read, so anything after them is left in the stream.
+    while(wheelsRead < header.numberOfWheels && std::getline(wheelsFile, line))
+    {
+        try
+        {
+            // Records the letters the wheel offers, over the positions the traversal would visit.
+            window[wheelsRead % window.size()] = Wheels::readWheel(line, header.lettersPerWheel);
+        }
+        catch(const std::invalid_argument&)
+        {
+            // Words found so far are written before the error is reported.
+            writer.flush();
+            throw;
+        }
+
+        wheelsRead++;
+
+        // Every wheel the oldest start wheel of the window can reach has been read, so its words are final.
+        // They are handed to the stream at once, rather than when the buffer fills.
+        if(wheelsRead >= window.size() && search.search(wheelsRead - window.size(), window.size()))
+        {
+            writer.flush();
+        }
+    }
+
+    // The start wheels near the end of the file reach fewer wheels than the window holds.
+    for(size_t startWheel = wheelsRead >= window.size() ? wheelsRead - window.size() + 1 : 0; startWheel < wheelsRead; startWheel++)
+    {
+        search.search(startWheel, wheelsRead - startWheel);
+    }
+
+    writer.appendCount(found.size(), options.format);
+
+    return found.size();
+}
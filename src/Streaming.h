@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+
+#include "FlatDictionary.h"
+#include "Stats.h"
+#include "Utils.h"
+
+/// Solves lettered wheels read one wheel at a time, for sequences of wheels too long to hold in memory.
+class Streaming
+{
+  public:
+    /**
+     * Finds every word formed by the wheels of a wheels file, reading the wheels as the search reaches them.
+     *
+     * No word is longer than the longest word in the dictionary, so the search starting at a wheel only needs
+     * that many wheels. Only the letter masks of a window of that many wheels are held. Once the last wheel a
+     * start wheel can reach has been read, the words starting there are searched for, and those not already
+     * found are written to the stream. The memory used is bounded by the dictionary, however many wheels the file holds.
+     *
+     * Words are written in the order they are found, followed by the number of words found, in the format
+     * selected by the options. With --count-only only the number is written.
+     *
+     * Only the number of wheels declared by the header is read; any line after them is left in the stream.
+     *
+     * An exception will be thrown if the wheels file is malformed. Words found before the malformed wheel
+     * have already been written.
+     *
+     * @param wheelsFile: the stream of the wheels file, positioned at its start
+     * @param dictionary: the dictionary to cross-reference the permutations with. It must hold every word
+     *   the wheels can form, so it is built without a maximum word size.
+     * @param options: the options selecting the format and content of the output
+     * @param stream: the stream to write the words to
+     * @param counters: receives the search counters, or nullptr to not count. Ignored if the counters are compiled out.
+     * @return the number of unique words found
+     */
+    static size_t solve(std::istream& wheelsFile, const FlatDictionary& dictionary, const Utils::Options& options,
+        std::ostream& stream, Stats::Counters* counters = nullptr);
+};
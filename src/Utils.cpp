@@ -1,28 +1,230 @@
 #include "Utils.h"
 
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <exception>
 #include <iostream>
+#include <vector>
+#include <filesystem>
 
-bool Utils::isValidString(const std::string& str)
+#include "WordSet.h"
+#include "ResultWriter.h"
+
+bool Utils::isValidString(std::string_view str)
+{
+    // Ensures given character contains only [a-z][A-Z].
+    return Alphabets::isValidString<LatinAlphabet>(str);
+}
+
+Utils::Options Utils::parseOptions(int argc, char* argv[])
 {
-    for(size_t i = 0; i < str.size(); i++)
+    Options options;
+    std::vector<std::string> paths;
+
+    for(int i = 1; i < argc; i++)
     {
-        // Ensures given character contains only [a-z][A-Z].
-        if(!((str[i] >= 'A' && str[i] <= 'Z') || (str[i] >= 'a' && str[i] <= 'z')))
+        const std::string arg(argv[i]);
+
+        if(arg == "--threads")
+        {
+            options.threads = parseCount(arg, i + 1 < argc ? argv[++i] : "");
+        }
+        else if(arg == "--engine")
         {
-            return false;
+            const std::string engine = parseValue(arg, i + 1 < argc ? argv[++i] : "");
+
+            if(engine != "dfs" && engine != "bitmask" && engine != "multistart")
+            {
+                throw std::invalid_argument("The option --engine expects dfs, bitmask or multistart. Value: " + engine);
+            }
+
+            options.engine = engine == "dfs" ? Options::DFS : engine == "bitmask" ? Options::BITMASK : Options::MULTI_START;
+        }
+        else if(arg == "--memoize")
+        {
+            options.memoize = true;
+        }
+        else if(arg == "--format")
+        {
+            const std::string format = parseValue(arg, i + 1 < argc ? argv[++i] : "");
+
+            if(format != "text" && format != "jsonl")
+            {
+                throw std::invalid_argument("The option --format expects text or jsonl. Value: " + format);
+            }
+
+            options.format = format == "text" ? Options::TEXT : Options::JSON_LINES;
+        }
+        else if(arg == "--sort")
+        {
+            options.sortOutput = true;
+        }
+        else if(arg == "--count-only")
+        {
+            options.countOnly = true;
+        }
+        else if(arg == "--dawg")
+        {
+            options.dawg = true;
+        }
+        else if(arg == "--min-length")
+        {
+            options.minimumLength = parseCount(arg, i + 1 < argc ? argv[++i] : "");
+        }
+        else if(arg == "--top-k")
+        {
+            options.topK = parseCount(arg, i + 1 < argc ? argv[++i] : "");
+        }
+        else if(arg == "--longest")
+        {
+            options.longest = true;
+        }
+        else if(arg == "--first")
+        {
+            options.firstCount = parseCount(arg, i + 1 < argc ? argv[++i] : "");
+        }
+        else if(arg == "--interactive")
+        {
+            options.interactive = true;
+        }
+        else if(arg == "--stream")
+        {
+            options.stream = true;
+        }
+        else if(arg == "--stats")
+        {
+            const std::string format = parseValue(arg, i + 1 < argc ? argv[++i] : "");
+
+            if(format != "text" && format != "json")
+            {
+                throw std::invalid_argument("The option --stats expects text or json. Value: " + format);
+            }
+
+            options.stats = true;
+            options.statsFormat = format == "text" ? Options::TEXT : Options::JSON_LINES;
+        }
+        else if(arg == "--index")
+        {
+            options.indexPath = parseValue(arg, i + 1 < argc ? argv[++i] : "");
+        }
+        else if(arg == "--build-index")
+        {
+            options.buildIndexPath = parseValue(arg, i + 1 < argc ? argv[++i] : "");
+        }
+        else if(arg == "--batch")
+        {
+            options.batchPath = parseValue(arg, i + 1 < argc ? argv[++i] : "");
+        }
+        else if(arg == "--output-dir")
+        {
+            options.outputDirectory = parseValue(arg, i + 1 < argc ? argv[++i] : "");
+        }
+        else if(arg == "--serve")
+        {
+            options.serveAddress = parseValue(arg, i + 1 < argc ? argv[++i] : "");
+        }
+        else if(arg == "--reload")
+        {
+            options.reloadSeconds = parseCount(arg, i + 1 < argc ? argv[++i] : "");
+        }
+        else if(arg.rfind("--", 0) == 0)
+        {
+            throw std::invalid_argument("Unrecognised option: " + arg);
+        }
+        else
+        {
+            paths.push_back(arg);
         }
     }
 
-    return true;
-}
+    // Streamed words are written as they are found, so they cannot be sorted first.
+    if(options.stream && options.sortOutput)
+    {
+        throw std::invalid_argument("The options --stream and --sort cannot be combined.");
+    }
+
+    // The streamed mode reads its wheels from the wheels file, and walks them with its own single threaded search.
+    if(options.stream && (!options.batchPath.empty() || !options.serveAddress.empty()))
+    {
+        throw std::invalid_argument("The option --stream cannot be combined with --batch or --serve.");
+    }
+
+    if(options.stream && (options.threads != 1 || options.engine != Options::DFS || options.memoize))
+    {
+        throw std::invalid_argument("The options --threads, --engine and --memoize cannot be combined with --stream.");
+    }
+
+    // The interactive mode reads its replacements from the console, and solves each one without a report.
+    if(options.interactive && (!options.batchPath.empty() || !options.serveAddress.empty()))
+    {
+        throw std::invalid_argument("The option --interactive cannot be combined with --batch or --serve.");
+    }
+
+    if(options.interactive && options.stats)
+    {
+        throw std::invalid_argument("The options --interactive and --stats cannot be combined.");
+    }
+
+    // Replacements are solved by the incremental solver's own single threaded walk, on either dictionary layout.
+    if(options.interactive && (options.threads != 1 || options.engine != Options::DFS || options.memoize))
+    {
+        throw std::invalid_argument("The options --threads, --engine and --memoize cannot be combined with --interactive.");
+    }
+
+    if(options.topK > 0 && options.longest)
+    {
+        throw std::invalid_argument("The options --top-k and --longest cannot be combined.");
+    }
+
+    // The streamed and interactive modes report every word as it is found or changes, before any ranking is known.
+    if((options.stream || options.interactive) && (options.topK > 0 || options.longest || options.minimumLength > 0))
+    {
+        throw std::invalid_argument("The options --top-k, --longest and --min-length cannot be combined with --stream or --interactive.");
+    }
+
+    // The first words are written as they are found, which only the single puzzle mode does.
+    if(options.firstCount > 0 && (options.sortOutput || options.stream || options.interactive || options.topK > 0
+        || options.longest || options.minimumLength > 0 || !options.batchPath.empty() || !options.serveAddress.empty()))
+    {
+        throw std::invalid_argument("The option --first cannot be combined with --sort, --stream, --interactive, --top-k,"
+            " --longest, --min-length, --batch or --serve.");
+    }
+
+    // The first words are found in the order of the single threaded dfs traversal.
+    if(options.firstCount > 0 && (options.threads != 1 || options.engine != Options::DFS))
+    {
+        throw std::invalid_argument("The options --threads and --engine cannot be combined with --first.");
+    }
+
+    // The report describes a single search, and batch and server modes run many.
+    if(options.stats && (!options.batchPath.empty() || !options.serveAddress.empty()))
+    {
+        throw std::invalid_argument("The option --stats cannot be combined with --batch or --serve.");
+    }
+
+    // Only a server outlives its dictionary file's changes.
+    if(options.reloadSeconds > 0 && options.serveAddress.empty())
+    {
+        throw std::invalid_argument("The option --reload is only supported with --serve.");
+    }
+
+    // In batch and server modes the wheels are not read from a file argument, so only the dictionary is provided.
+    if(!options.batchPath.empty() || !options.serveAddress.empty())
+    {
+        if(paths.empty())
+        {
+            throw std::invalid_argument("In batch and server modes, the CLI argument must be the file name/path for the dictionary (.txt).\n"
+                "Aborting the program...");
+        }
+
+        options.dictionaryPath = paths[0];
+
+        return options;
+    }
 
-void Utils::initFiles(int argc, char* argv[], std::ifstream& wheelsFile, std::ifstream& dictionaryFile)
-{
     // Not enough input arguments. A file name for the dictionary and the wheel combination must be provided.
-    if(argc < 3)
+    if(paths.size() < 2)
     {
         std::string out("At least 2 CLI arguments must be provided to run the program.\n"
             "Argument one must be the file name/path for the lettered wheels (.txt).\n"
@@ -32,8 +234,21 @@ void Utils::initFiles(int argc, char* argv[], std::ifstream& wheelsFile, std::if
         throw(std::invalid_argument(out));
     }
 
-    wheelsFile.open(argv[1]);
-    dictionaryFile.open(argv[2]);
+    options.wheelsPath = paths[0];
+    options.dictionaryPath = paths[1];
+
+    return options;
+}
+
+void Utils::initFiles(const Options& options, std::ifstream& wheelsFile, std::ifstream& dictionaryFile)
+{
+    wheelsFile.open(options.wheelsPath);
+
+    // The dictionary .txt file is only needed when there is no existing dictionary image to load instead.
+    if(options.indexPath.empty() || !std::filesystem::exists(options.indexPath))
+    {
+        dictionaryFile.open(options.dictionaryPath);
+    }
 
     // Unable to create a stream for the lettered wheels - the file could not be found or accessed.
     if(wheelsFile.fail() || dictionaryFile.fail())
@@ -44,15 +259,15 @@ void Utils::initFiles(int argc, char* argv[], std::ifstream& wheelsFile, std::if
         if(wheelsFile.fail() && dictionaryFile.fail())
         {
             out.append("Unable to locate / access the files with paths : ");
-            out.append(argv[1]);
+            out.append(options.wheelsPath);
             out.append(" & ");
-            out.append(argv[2]);
+            out.append(options.dictionaryPath);
         }
         // One file has failed to be accessed.
         else
         {
             out.append("Unable to locate / access the file with path : ");
-            out.append(wheelsFile.fail() ? argv[1] : argv[2]);
+            out.append(wheelsFile.fail() ? options.wheelsPath : options.dictionaryPath);
         }
 
         throw(std::invalid_argument(out));
@@ -72,12 +287,40 @@ void Utils::closeFiles(std::ifstream& wheelsFile, std::ifstream& dictionaryFile)
     }
 }
 
-void Utils::printResult(const std::unordered_set<std::string>& result)
+void Utils::printResult(const WordSet& result, const Options& options)
+{
+    printResult(result, options, std::cout);
+}
+
+void Utils::printResult(const WordSet& result, const Options& options, std::ostream& stream)
+{
+    ResultWriter::write(result, options, stream);
+}
+
+size_t Utils::parseCount(const std::string& option, const std::string& value)
+{
+    // Only plain non-negative integers are accepted, which std::stoull alone would not enforce.
+    if(value.empty() || value.find_first_not_of("0123456789") != std::string::npos)
+    {
+        throw std::invalid_argument("The option " + option + " expects a non-negative integer. Value: " + value);
+    }
+
+    try
+    {
+        return std::stoull(value);
+    }
+    catch(const std::out_of_range&)
+    {
+        throw std::invalid_argument("The value of the option " + option + " is too large. Value: " + value);
+    }
+}
+
+std::string Utils::parseValue(const std::string& option, const std::string& value)
 {
-    for(const auto& foundWord : result)
+    if(value.empty())
     {
-        std::cout << foundWord << std::endl;
+        throw std::invalid_argument("The option " + option + " expects a value.");
     }
 
-    std::cout << "Found " << result.size() << " unique words" << std::endl;
+    return value;
 }
\ No newline at end of file
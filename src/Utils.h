@@ -1,15 +1,94 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <fstream>
-#include <unordered_set>
+
+#include "Alphabet.h"
+
+class WordSet;
 
 /// A series of helper functions for improved code readability.
 class Utils
 {
   public:
      /// The number of letters in the Latin alphabet
-    static const unsigned char LETTERS_IN_ALPHABET = 26;
+    static const unsigned char LETTERS_IN_ALPHABET = LatinAlphabet::SIZE;
+
+    /// The settings provided as CLI arguments.
+    struct Options
+    {
+        /**
+         * The engines that can search the wheels.
+         * DFS = advances one letter position at a time, probing every letter of every wheel.
+         * BITMASK = visits only the letters both on the next wheel and continuing the current prefix.
+         * MULTI_START = walks the dictionary once, carrying the set of start wheels each prefix can be formed from.
+         */
+        enum ENGINE
+        {
+            DFS,
+            BITMASK,
+            MULTI_START
+        };
+
+        /**
+         * The formats the found words can be written in.
+         * TEXT = one word per line, followed by a line counting the words.
+         * JSON_LINES = one JSON object per word, followed by an object counting the words.
+         */
+        enum FORMAT
+        {
+            TEXT,
+            JSON_LINES
+        };
+
+        /// The file name/path for the lettered wheels (.txt).
+        std::string wheelsPath;
+        /// The file name/path for the dictionary (.txt).
+        std::string dictionaryPath;
+        /// The number of threads used by the search. 0 selects the number of hardware threads.
+        size_t threads = 1;
+        /// The engine used to search the wheels.
+        ENGINE engine = DFS;
+        /// True to skip repeated (wheel, dictionary node) states in the dfs engine.
+        bool memoize = false;
+        /// The format the found words are written in.
+        FORMAT format = TEXT;
+        /// True to write the found words in alphabetical order, rather than shortest first.
+        bool sortOutput = false;
+        /// True to only write the number of words found.
+        bool countOnly = false;
+        /// True to build the dictionary as a DAWG, sharing the nodes of common suffixes, rather than as a trie.
+        bool dawg = false;
+        /// The file name/path of a prebuilt dictionary image to load, or empty to build the dictionary from text.
+        std::string indexPath;
+        /// The file name/path to write the dictionary image to after building it, or empty to not write one.
+        std::string buildIndexPath;
+        /// The file name/path of a list of wheels files to solve against one dictionary, or empty to solve a single wheels file.
+        std::string batchPath;
+        /// The directory each batch puzzle's result is written to, or empty to write every result to the console.
+        std::string outputDirectory;
+        /// The number of letters in the shortest word to find, or 0 to find words of every length.
+        size_t minimumLength = 0;
+        /// The number of longest words to find, ties going to the alphabetically first, or 0 to find every word.
+        size_t topK = 0;
+        /// True to find only the words of the greatest length formed.
+        bool longest = false;
+        /// The number of words after which the search stops, or 0 to find every word.
+        size_t firstCount = 0;
+        /// True to read wheel replacements from the console after solving, updating the result after each one.
+        bool interactive = false;
+        /// True to read the wheels one at a time and write the words found as the search passes each wheel.
+        bool stream = false;
+        /// True to write a report of the search counters and the time spent on each phase to the error stream.
+        bool stats = false;
+        /// The format the --stats report is written in.
+        FORMAT statsFormat = TEXT;
+        /// The address a solver server listens on, "unix:PATH" or "tcp:PORT", or empty to solve and exit.
+        std::string serveAddress;
+        /// The interval in seconds at which a solver server checks the dictionary file for changes, or 0 to never reload it.
+        size_t reloadSeconds = 0;
+    };
 
     /**
      * Determines whether all characters in the given string are in the set [A-Z][a-z].
@@ -17,19 +96,52 @@ class Utils
      * @param: str the string to query
      * @return true if the string is valid ([a-z][A-Z]), else false
      */
-    static bool isValidString(const std::string& str);
+    static bool isValidString(std::string_view str);
     /**
-     * Attempts to open two files: one representing the lettered wheels and one for the dictionary.
-     * The second and third CLI arguments should both refer to .txt files, the wheels file and the dictionary file, respectively.
+     * Reads the CLI arguments into a set of options.
+     * The first two arguments that are not options should refer to .txt files, the wheels file and the dictionary file, respectively.
+     * In batch and server modes the wheels are not provided as a file, so the only such argument is the dictionary file.
      * 
-     * An exception will be thrown if either file cannot be located/accessed and the program will terminate.
+     * Supported options:
+     *   --threads N: searches with N threads, or with every hardware thread if N is 0
+     *   --engine NAME: searches with the dfs (default), bitmask or multistart engine
+     *   --memoize: skips dfs subtrees already searched from the same wheel and dictionary node
+     *   --format NAME: writes the found words as text (default) or jsonl
+     *   --sort: writes the found words in alphabetical order
+     *   --count-only: writes only the number of words found
+     *   --dawg: builds the dictionary as a minimized DAWG, which holds large lexicons in a fraction of the memory
+     *   --min-length L: finds only the words of at least L letters
+     *   --top-k N: finds only the N longest words
+     *   --longest: finds only the words of the greatest length formed
+     *   --first N: writes the first N words found, in the order found, and stops the search there
+     *   --interactive: after solving, reads "WHEEL LETTERS" replacements from the console and writes the words each adds or removes
+     *   --stream: reads the wheels one at a time, writing the words found as the search passes each wheel
+     *   --stats FORMAT: writes the search counters and phase timings to the error stream, as text or json
+     *   --index PATH: loads the dictionary from the image at PATH, rebuilding the image if it is missing or unusable
+     *   --build-index PATH: builds the dictionary from text and writes its image to PATH
+     *   --batch PATH: solves every wheels file listed in PATH, one path per line, against a single dictionary
+     *   --output-dir DIR: writes the result of each batch puzzle to its own file in DIR
+     *   --serve ADDRESS: answers puzzles sent to ADDRESS, "unix:PATH" or "tcp:PORT", until terminated
+     *   --reload SECONDS: in server mode, checks the dictionary file every SECONDS seconds and swaps in a rebuilt dictionary when it changes
+     * 
+     * An exception will be thrown if an argument is missing, unrecognised or malformed.
      * 
      * @param argc: the number of provided CLI arguments
      * @param argv: the CLI arguments
+     * @return the options read from the CLI arguments
+     */
+    static Options parseOptions(int argc, char* argv[]);
+    /**
+     * Attempts to open two files: one representing the lettered wheels and one for the dictionary.
+     * The dictionary file is not opened if an existing dictionary image is provided with --index.
+     * 
+     * An exception will be thrown if either file cannot be located/accessed and the program will terminate.
+     * 
+     * @param options: the options holding the paths of both files
      * @param wheelsFile: the file object pointing to the .txt file representing the lettered wheels
      * @param dictionaryFile: the file object pointing to the .txt file representing the dictionary
      */
-    static void initFiles(int argc, char* argv[], std::ifstream& wheelsFile, std::ifstream& dictionaryFile);
+    static void initFiles(const Options& options, std::ifstream& wheelsFile, std::ifstream& dictionaryFile);
     /**
      * Closes two files: one representing the lettered wheels and one for the dictionary.
      *
@@ -38,10 +150,25 @@ class Utils
      */
     static void closeFiles(std::ifstream& wheelsFile, std::ifstream& dictionaryFile);
     /**
-     * Prints each string entry in the provided unordered_set and the total number of entries.
+     * Prints each word in the provided collection and the total number of words.
      * Each entry represents a unique word found in the lettered wheels that has been found in the provided dictionary.
      * 
      * @param result: the collection of unique words formed by the lettered wheels and present in the dictionary
+     * @param options: the options selecting the format, order and content of the output
      */
-    static void printResult(const std::unordered_set<std::string>& result);
+    static void printResult(const WordSet& result, const Options& options);
+    /**
+     * Writes each word in the provided collection and the total number of words to a stream.
+     * 
+     * @param result: the collection of unique words formed by the lettered wheels and present in the dictionary
+     * @param options: the options selecting the format, order and content of the output
+     * @param stream: the stream to write to
+     */
+    static void printResult(const WordSet& result, const Options& options, std::ostream& stream);
+
+  private:
+    // Converts the value of a numeric CLI option, throwing std::invalid_argument if it is malformed.
+    static size_t parseCount(const std::string& option, const std::string& value);
+    // Reads the value of a CLI option, throwing std::invalid_argument if it is missing.
+    static std::string parseValue(const std::string& option, const std::string& value);
 };
\ No newline at end of file
@@ -1,31 +1,90 @@
 #include "Wheels.h"
 
-#include <fstream>
+#include <istream>
 #include <vector>
 #include <exception>
 #include <string>
+#include <string_view>
 #include <iostream>
+#include <bit>
 
 #include "Utils.h"
+#include "Alphabet.h"
 #include "Dictionary.h"
+#include "FlatDictionary.h"
 
-Wheels::Wheels() {}
+template <typename Alphabet>
+BasicWheels<Alphabet>::BasicWheels() {}
 
-Wheels::Wheels(std::ifstream& file)
+template <typename Alphabet>
+BasicWheels<Alphabet>::BasicWheels(std::istream& file)
 {
+    const Header header = readHeader(file);
+    numberOfWheels = header.numberOfWheels;
+    lettersPerWheel = header.lettersPerWheel;
+    // Reserves space for the number of wheels in a vector, using an integer read from the wheels file.
+    wheels.reserve(numberOfWheels);
+
+    std::string line;
+
+    while(std::getline(file, line))
+    {
+        // Records the letters the wheel offers, over the positions the traversal visits.
+        wheelMasks.push_back(readWheel(line, lettersPerWheel));
+
+        // Reserves space for the number of letters in each wheel in a vector, using an integer read from the wheels file.
+        std::vector<char> wheel;
+        wheel.reserve(lettersPerWheel);
+
+        // Create a vector representing an individual wheel and push it to the enclosing wheels vector.
+        for(size_t i = 0; i < line.length(); i++)
+        {
+            wheel.push_back(Alphabet::LETTERS[Alphabet::INDEX[static_cast<unsigned char>(line[i])]]);
+        }
+
+        wheels.push_back(wheel);
+    }
+
+    letterWheels.assign(Alphabet::SIZE, std::vector<uint64_t>((numberOfWheels + 63) / 64, 0));
+
+    for(size_t wheel = 0; wheel < wheelMasks.size() && wheel < numberOfWheels; wheel++)
+    {
+        wheelLetters |= wheelMasks[wheel];
+
+        for(uint32_t letters = wheelMasks[wheel]; letters != 0; letters &= letters - 1)
+        {
+            letterWheels[std::countr_zero(letters)][wheel / 64] |= uint64_t(1) << (wheel % 64);
+        }
+    }
+
+    // A permutation never spans more than every wheel, so its buffers are sized once and updated in place.
+    permutation.assign(numberOfWheels, '\0');
+    permutationLetters.assign(numberOfWheels, 0);
+
+    // Push the first first two characters to the permutation. The starting point of the DFS as it has the length of a legal word.
+    // A single wheel cannot form a word, so no permutation is started.
+    if(canPermute())
+    {
+        pushLetter<typename BasicDictionary<Alphabet>::Cursor>(wheelIndex, letterIndex, nullptr);
+        pushLetter<typename BasicDictionary<Alphabet>::Cursor>(endWheelIndex, endLetterIndex, nullptr);
+    }
+}
+
+template <typename Alphabet>
+typename BasicWheels<Alphabet>::Header BasicWheels<Alphabet>::readHeader(std::istream& file)
+{
+    Header header;
     std::string line;
 
     try
     {
         // Reads the number of wheels from the wheels file.
         std::getline(file, line);
-        numberOfWheels = std::stoll(line);
-        // Reserves space for the number of wheels in a vector, using an integer read from the wheels file.
-        wheels.reserve(numberOfWheels);
+        header.numberOfWheels = std::stoll(line);
 
         // Reads the number of letters per wheel from the wheel file.
         std::getline(file, line);
-        lettersPerWheel = std::stoll(line);
+        header.lettersPerWheel = std::stoll(line);
     }
     catch(const std::invalid_argument& e)
     {
@@ -39,60 +98,141 @@ Wheels::Wheels(std::ifstream& file)
     }
 
     // Ensures that the there are enough wheels (1) required to form a word with enough letters in each wheel (2).
-    if(numberOfWheels < 1 || lettersPerWheel < 2)
+    if(header.numberOfWheels < 1 || header.lettersPerWheel < 2)
     {
         throw std::invalid_argument("Not enough rows or columns inside the lettered wheels."
             " A wheel must contain at least two letters and there must be at least one wheel.");
     }
 
-    while(std::getline(file, line))
+    return header;
+}
+
+template <typename Alphabet>
+uint32_t BasicWheels<Alphabet>::readWheel(std::string_view line, const size_t lettersPerWheel)
+{
+    // Letters representing an individual wheel are not letters of the alphabet.
+    if(!Alphabets::isValidString<Alphabet>(line))
     {
-        // Letters representing an individual wheel are not in the expected values [a-z][A-Z].
-        if(!Utils::isValidString(line))
-        {
-            std::string arg;
-            arg.append("Encountered a character \"").append({ line }).append("\" not in the expected range of {[a-z][A-Z]}.").append(
-                "\nAborting insertion of the wheel letters.\n");
+        std::string arg;
+        arg.append("Encountered a character \"").append(line).append("\" not in the expected range of ")
+            .append(Alphabet::DESCRIPTION).append(".").append("\nAborting insertion of the wheel letters.\n");
+
+        throw std::invalid_argument(arg);
+    }
 
-            throw std::invalid_argument(arg);
+    uint32_t mask = 0;
+
+    for(size_t i = 0; i < line.length() && i < lettersPerWheel; i++)
+    {
+        mask |= 1u << Alphabet::INDEX[static_cast<unsigned char>(line[i])];
+    }
+
+    return mask;
+}
+
+template <typename Alphabet>
+size_t BasicWheels<Alphabet>::getLettersPerWheel(void) const
+{
+    return lettersPerWheel;
+}
+
+template <typename Alphabet>
+size_t BasicWheels<Alphabet>::getNumberOfWheels(void) const
+{
+    return numberOfWheels;
+}
+
+template <typename Alphabet>
+size_t BasicWheels<Alphabet>::getEndWheelIndex(void) const
+{
+    return endWheelIndex;
+}
+
+template <typename Alphabet>
+uint32_t BasicWheels<Alphabet>::getWheelMask(size_t wheel) const
+{
+    return wheelMasks[wheel];
+}
+
+template <typename Alphabet>
+bool BasicWheels<Alphabet>::canForm(std::string_view word) const
+{
+    // The whole word is checked first, so a malformed dictionary is rejected whatever the wheels are.
+    if(!Alphabets::isValidString<Alphabet>(word))
+    {
+        return true;
+    }
+
+    if(word.size() > numberOfWheels)
+    {
+        return false;
+    }
+
+    // Rejects most words at once, by a letter that is on no wheel.
+    for(char c : word)
+    {
+        if(!(wheelLetters & (1u << Alphabet::INDEX[static_cast<unsigned char>(c)])))
+        {
+            return false;
         }
-        
-        // Reserves space for the number of letters in each wheel in a vector, using an integer read from the wheels file.
-        std::vector<char> wheel;
-        wheel.reserve(lettersPerWheel);
+    }
 
-        // Create a vector representing an individual wheel and push it to the enclosing wheels vector.
-        for(size_t i = 0; i < line.length(); i++)
+    // Bit s is set while the wheels from wheel s onwards offer every letter tested so far. Testing the letter at
+    // position i keeps the start wheels s whose wheel s + i offers it, by shifting that letter's wheels down by i.
+    // Wheel s + i does not exist for the later start wheels, so its zero bits also clear every start too late to fit the word.
+    thread_local std::vector<uint64_t> starts;
+    starts.assign((numberOfWheels - word.size() + 64) / 64, ~uint64_t(0));
+
+    for(size_t i = 0; i < word.size(); i++)
+    {
+        const std::vector<uint64_t>& wheels = letterWheels[Alphabet::INDEX[static_cast<unsigned char>(word[i])]];
+        const size_t offset = i / 64;
+        const size_t shift = i % 64;
+        uint64_t remaining = 0;
+
+        for(size_t block = 0; block < starts.size(); block++)
         {
-            wheel.push_back(std::toupper(line[i]));
+            const uint64_t low = block + offset < wheels.size() ? wheels[block + offset] : 0;
+            const uint64_t high = shift != 0 && block + offset + 1 < wheels.size() ? wheels[block + offset + 1] : 0;
+
+            starts[block] &= shift != 0 ? (low >> shift) | (high << (64 - shift)) : low;
+            remaining |= starts[block];
         }
 
-        wheels.push_back(wheel);
+        if(remaining == 0)
+        {
+            return false;
+        }
     }
 
-    // Push the first first two characters to the WheelPermutation. The starting point of the DFS as it has the length of a legal word.
-    wheelPermutation.push({ wheels[wheelIndex][letterIndex], letterIndex });
-    wheelPermutation.push({ wheels[endWheelIndex][endLetterIndex], endLetterIndex });
+    return true;
 }
 
-size_t Wheels::getLettersPerWheel(void) const
+template <typename Alphabet>
+std::string_view BasicWheels<Alphabet>::advancePermutation(Dictionary::SEARCH_STATUS state)
 {
-    return lettersPerWheel;
+    progressPermutation<typename BasicDictionary<Alphabet>::Cursor>(state, nullptr);
+
+    return getCurrentPermutation();
 }
 
-size_t Wheels::getNumberOfWheels(void) const
+template <typename Alphabet>
+template <typename Cursor>
+void BasicWheels<Alphabet>::advancePermutation(Dictionary::SEARCH_STATUS state, Cursor& cursor)
 {
-    return numberOfWheels;
+    progressPermutation(state, &cursor);
 }
 
-std::string Wheels::advancePermutation(Dictionary::SEARCH_STATUS state)
+template <typename Alphabet>
+template <typename Cursor>
+void BasicWheels<Alphabet>::progressPermutation(Dictionary::SEARCH_STATUS state, Cursor* cursor)
 {
     switch(state)
     {
         // In these states the search cannot continue in depth, so progress to the next letter on the last wheel.
         case Dictionary::HIT_TERMINAL:
         case Dictionary::MISS:
-            wheelPermutation.pop();
+            popLetter(cursor);
             endLetterIndex++;
             break;
         // In these states more words in the dictionary continue from the current string permutation, so continue in depth
@@ -108,9 +248,9 @@ std::string Wheels::advancePermutation(Dictionary::SEARCH_STATUS state)
     if(state == Dictionary::HIT_TERMINAL || state == Dictionary::MISS)
     {
         // Continues to pop back on the wheel letters until a letter that isn't at the end of the wheel is accessed.
-        while(wheelPermutation.size() > 1 && endLetterIndex >= Wheels::getLettersPerWheel())
+        while(permutationLength > 1 && endLetterIndex >= getLettersPerWheel())
         {
-            revertAndProgressPermutation();
+            revertAndProgressPermutation(cursor);
         }
     }
 
@@ -120,19 +260,26 @@ std::string Wheels::advancePermutation(Dictionary::SEARCH_STATUS state)
         // Progresses to the next element along the last wheel.
         if(endWheelIndex >= getNumberOfWheels())
         {
-            revertAndProgressPermutation();
+            revertAndProgressPermutation(cursor);
         }
 
         // Continues to pop back on the wheel letters until a letter that isn't at the end of the wheel is accessed.
-        while(wheelPermutation.size() > 1 && endLetterIndex >= Wheels::getLettersPerWheel())
+        while(permutationLength > 1 && endLetterIndex >= getLettersPerWheel())
         {
-            revertAndProgressPermutation();
+            revertAndProgressPermutation(cursor);
         }
     }
 
+    // A restricted traversal ends once its two letter prefix has been popped.
+    if(isRestricted && permutationLength <= 1)
+    {
+        isExhausted = true;
+        return;
+    }
+
     // Handles cases where all paths for a particular starting node has been exhausted,
     // so the starting node must be progressed.
-    if(wheelPermutation.size() <= 1 && endLetterIndex >= getLettersPerWheel())
+    if(permutationLength <= 1 && endLetterIndex >= getLettersPerWheel())
     {
         // Increase the starting letter index on its current wheel.
         if(letterIndex < getLettersPerWheel() - 1)
@@ -150,54 +297,94 @@ std::string Wheels::advancePermutation(Dictionary::SEARCH_STATUS state)
         endWheelIndex = wheelIndex + 1;
         endLetterIndex = 0;
 
-        // Empties the wheelPermutation stack, resetting it for the new starting letter.
-        while(!wheelPermutation.empty())
+        // Empties the permutation, resetting it for the new starting letter.
+        permutationLength = 0;
+
+        if(cursor != nullptr)
         {
-            wheelPermutation.pop();
+            cursor->reset();
         }
 
         // Sets the initial permutation. The conditional ensures that there isn't an attempt to
         // access beyond the last wheel, causing an out of bounds error.
         if(canPermute())
         {
-            wheelPermutation.push(std::pair<char, size_t>({ wheels[wheelIndex][letterIndex] }, letterIndex));
-            wheelPermutation.push(std::pair<char, size_t>({ wheels[endWheelIndex][endLetterIndex] }, endLetterIndex));
+            pushLetter(wheelIndex, letterIndex, cursor);
+            pushLetter(endWheelIndex, endLetterIndex, cursor);
         }
     }
     // Paths are not exhausted for the starting node, so continue.
     else
     {
-        wheelPermutation.push(std::pair<char, size_t>({ wheels[endWheelIndex][endLetterIndex] }, endLetterIndex));
+        pushLetter(endWheelIndex, endLetterIndex, cursor);
     }
-
-    return Wheels::getCurrentPermutation();
 }
 
-bool Wheels::canPermute(void) const
+template <typename Alphabet>
+bool BasicWheels<Alphabet>::canPermute(void) const
 {
     // Can continue permutation as long as there is at least one wheel that can form the second character in a permutation..
-    return wheelIndex < numberOfWheels - 1;
+    return !isExhausted && wheelIndex < numberOfWheels - 1;
 }
 
-std::string Wheels::getCurrentPermutation()
+template <typename Alphabet>
+void BasicWheels<Alphabet>::restrictToSubtree(size_t wheelIndex, size_t letterIndex, size_t secondLetterIndex)
 {
-    std::string resultString;
-    // Copies the container storing the permutation to prevent compromising the original.
-    auto permutationCopy(wheelPermutation);
+    this->wheelIndex = wheelIndex;
+    this->letterIndex = letterIndex;
+    endWheelIndex = wheelIndex + 1;
+    endLetterIndex = secondLetterIndex;
+    isRestricted = true;
+    isExhausted = false;
 
-    // Pop all elements of the stack, prepending each found character to the result string.
-    while(!permutationCopy.empty())
-    {
-        resultString.insert(0, { permutationCopy.top().first });
-        permutationCopy.pop();
-    }
+    permutationLength = 0;
+
+    pushLetter<typename BasicDictionary<Alphabet>::Cursor>(wheelIndex, letterIndex, nullptr);
+    pushLetter<typename BasicDictionary<Alphabet>::Cursor>(endWheelIndex, endLetterIndex, nullptr);
+}
 
-    return resultString;
+template <typename Alphabet>
+std::string_view BasicWheels<Alphabet>::getCurrentPermutation(void) const
+{
+    return std::string_view(permutation.data(), permutationLength);
 }
 
-void Wheels::revertAndProgressPermutation()
+template <typename Alphabet>
+template <typename Cursor>
+void BasicWheels<Alphabet>::revertAndProgressPermutation(Cursor* cursor)
 {
     endWheelIndex--;
-    endLetterIndex = wheelPermutation.top().second + 1;
-    wheelPermutation.pop();
-}
\ No newline at end of file
+    endLetterIndex = permutationLetters[permutationLength - 1] + 1;
+    popLetter(cursor);
+}
+
+template <typename Alphabet>
+template <typename Cursor>
+void BasicWheels<Alphabet>::pushLetter(size_t wheel, size_t letter, Cursor* cursor)
+{
+    permutation[permutationLength] = wheels[wheel][letter];
+    permutationLetters[permutationLength] = letter;
+    permutationLength++;
+
+    if(cursor != nullptr)
+    {
+        cursor->descend(wheels[wheel][letter]);
+    }
+}
+
+template <typename Alphabet>
+template <typename Cursor>
+void BasicWheels<Alphabet>::popLetter(Cursor* cursor)
+{
+    permutationLength--;
+
+    if(cursor != nullptr)
+    {
+        cursor->ascend();
+    }
+}
+
+// The alphabet the wheels hold, and the cursor types they can be advanced with. See Alphabet.h.
+template class BasicWheels<LatinAlphabet>;
+template void Wheels::advancePermutation(Dictionary::SEARCH_STATUS state, Dictionary::Cursor& cursor);
+template void Wheels::advancePermutation(Dictionary::SEARCH_STATUS state, FlatDictionary::Cursor& cursor);
@@ -1,21 +1,23 @@
 #pragma once
 
-#include <fstream>
+#include <istream>
 #include <vector>
-#include <stack>
-#include <utility>
+#include <string>
+#include <string_view>
+#include <cstdint>
 
 #include "Dictionary.h"
+#include "Alphabet.h"
 
 /*
- * Represents a series of uniform rotating wheels containing characters [A-Z].
+ * Represents a series of uniform rotating wheels containing the letters of an alphabet, [A-Z] for Wheels.
  * By taking a character from a subset of contiguous wheels, words can be formed.
  * 
  * To generate the wheels, the program expects a .txt file first containing two integers
  * each on separate lines. These represent the number of wheels and the number of letters
  * per wheel, respectively.
  * 
- * The following lines should be a grid of characters [A-Z] (case-insensitive) that follow
+ * The following lines should be a grid of letters of the alphabet (case-insensitive) that follow
  * the previously described proportions. Each horizontal lines forms a single wheel.
  * 
  * Example input:
@@ -28,17 +30,49 @@
  * Words most flow from an upper wheel to a lower wheel and words do not wrap.
  * 
  * Words from this input (non-exhaustive): DIM, AH, IN.
+ * 
+ * The wheels are instantiated for LatinAlphabet, as Wheels.
  */
-class Wheels
+template <typename Alphabet>
+class BasicWheels
 {
+    static_assert(Alphabet::SIZE <= 26, "A set of letters must fit in the bits of a wheel mask.");
+
   public:
     /**
      * Constructor.
      * 
-     * @param file: a file object pointing to a .txt file, containing
-     * information to construct the Wheels object.
+     * @param file: a stream, such as a file object pointing to a .txt file, containing
+     * information to construct the Wheels object. The stream is read to its end.
+     */
+    BasicWheels(std::istream& file);
+
+    /// The sizes declared at the start of a wheels file.
+    struct Header
+    {
+        size_t numberOfWheels = 0;
+        size_t lettersPerWheel = 0;
+    };
+
+    /**
+     * Reads the number of wheels and the number of letters per wheel from the start of a wheels file.
+     * 
+     * An exception will be thrown if either is not an integer, or if there is not at least one wheel of at least two letters.
+     * 
+     * @param file: a stream positioned at the start of a wheels file, left positioned at the first wheel
+     * @return the sizes read
      */
-    Wheels(std::ifstream& file);
+    static Header readHeader(std::istream& file);
+    /**
+     * Reads the letters of a single wheel from its line of a wheels file.
+     * 
+     * An exception will be thrown if the line holds a character outside the alphabet.
+     * 
+     * @param line: the line of the wheel
+     * @param lettersPerWheel: the number of letters per wheel, beyond which letters are left out of the mask
+     * @return a mask with bit 0 set if the first letter of the alphabet is on the wheel, and so on
+     */
+    static uint32_t readWheel(std::string_view line, size_t lettersPerWheel);
     /**
      * Gets the number of lettered wheels.
      * 
@@ -51,6 +85,29 @@ class Wheels
      * @return the number of letters that appear on each wheel
      */
     size_t getLettersPerWheel(void) const;
+    /**
+     * Gets the index of the wheel supplying the final letter of the current permutation.
+     * 
+     * @return the index of the wheel ending the current permutation
+     */
+    size_t getEndWheelIndex(void) const;
+    /**
+     * Gets the set of distinct letters on a wheel.
+     * 
+     * @param wheel: the index of the wheel, in the range [0, numberOfWheels)
+     * @return a mask with bit 0 set if the first letter of the alphabet is on the wheel, and so on
+     */
+    uint32_t getWheelMask(size_t wheel) const;
+    /**
+     * Determines whether the wheels can form a word, that is whether some run of contiguous wheels offers
+     * the letters of the word in turn. Used to leave words no permutation can reach out of a dictionary.
+     * 
+     * A word holding a character outside the alphabet is not rejected, so that inserting it reports the error.
+     * 
+     * @param word: the word to test, in either case
+     * @return true if the word can be formed by the wheels, else false
+     */
+    bool canForm(std::string_view word) const;
     /**
      * Generates a new permutation in the wheels via DFS traversal.
      * The new permutation is calculated based on the state of a dictionary lookup
@@ -63,9 +120,23 @@ class Wheels
      * to the permutation.
      * 
      * @param state: the search status that is used to compute
-     * @return a new permutation of the letered wheels represented as a string
+     * @return a new permutation of the letered wheels. The view is invalidated by the next change to the permutation.
      */
-    std::string advancePermutation(Dictionary::SEARCH_STATUS state);
+    std::string_view advancePermutation(Dictionary::SEARCH_STATUS state);
+    /**
+     * Generates a new permutation in the wheels via DFS traversal, as advancePermutation(state) does,
+     * while keeping the provided cursor positioned on the new permutation.
+     * 
+     * Every letter pushed to or popped from the permutation is mirrored on the cursor, so the
+     * status of the new permutation is available from the cursor with a single child lookup.
+     * The cursor must represent the current permutation when this method is called.
+     * Either a cursor of a BasicDictionary on the same alphabet, or a FlatDictionary::Cursor for Wheels, may be provided.
+     * 
+     * @param state: the search status of the current permutation
+     * @param cursor: a cursor representing the current permutation
+     */
+    template <typename Cursor>
+    void advancePermutation(Dictionary::SEARCH_STATUS state, Cursor& cursor);
     /**
      * Returns true if a new permutation can be safely computed, else false.
      * 
@@ -75,17 +146,42 @@ class Wheels
      */
     bool canPermute(void) const;
     /**
-     * Gets the next permutation of the lettered wheels.
+     * Restricts the DFS traversal to the permutations beginning with the letter at letterIndex on the wheel at
+     * wheelIndex, followed by the letter at secondLetterIndex on the next wheel.
      * 
-     * @return the next permutation of the lettered wheels
+     * The current permutation becomes that two letter prefix, and canPermute() returns false once every
+     * permutation extending it has been generated. Each such subtree is independent of the others,
+     * so they may be searched in any order, or concurrently by copies of this object.
+     * 
+     * @param wheelIndex: the index of the wheel starting the permutations, in the range [0, numberOfWheels - 1)
+     * @param letterIndex: the letter position starting the permutations
+     * @param secondLetterIndex: the letter position on the following wheel
      */
-    std::string getCurrentPermutation(void);
+    void restrictToSubtree(size_t wheelIndex, size_t letterIndex, size_t secondLetterIndex);
+    /**
+     * Gets the current permutation of the lettered wheels.
+     * The permutation is held in a buffer that is updated in place, so no allocation takes place.
+     * 
+     * @return the current permutation of the lettered wheels. The view is invalidated by the next change to the permutation.
+     */
+    std::string_view getCurrentPermutation(void) const;
 
   private:
     size_t numberOfWheels = 0;
     size_t lettersPerWheel = 0;
     std::vector<std::vector<char>> wheels;
-    std::stack<std::pair<char, size_t>> wheelPermutation;
+    // The distinct letters on each wheel, one bit per letter.
+    std::vector<uint32_t> wheelMasks;
+    // The letters offered by any wheel, one bit per letter.
+    uint32_t wheelLetters = 0;
+    // For each letter, the wheels offering it: bit w % 64 of entry w / 64 is set if wheel w does.
+    std::vector<std::vector<uint64_t>> letterWheels;
+    // The letters of the current permutation, of which the first permutationLength are in use.
+    std::string permutation;
+    // The letter position on its wheel of each letter in the current permutation.
+    std::vector<size_t> permutationLetters;
+    // The number of letters in the current permutation.
+    size_t permutationLength = 0;
 
     // The index of the wheel starting the permutation.
     size_t wheelIndex = 0;
@@ -95,8 +191,25 @@ class Wheels
     size_t letterIndex = 0;
     // The index of the letter position ending the permutation.
     size_t endLetterIndex = 0;
+    // True if the traversal is restricted to a single subtree by restrictToSubtree().
+    bool isRestricted = false;
+    // True once every permutation of the restricted subtree has been generated.
+    bool isExhausted = false;
 
-    Wheels(void);
+    BasicWheels(void);
+    // Computes the next permutation, mirroring every change on the cursor if one is provided.
+    template <typename Cursor>
+    void progressPermutation(Dictionary::SEARCH_STATUS state, Cursor* cursor);
     // Used to handle permutations when attempting to access letter positions and wheels out of bounds.
-    void revertAndProgressPermutation(void);
+    template <typename Cursor>
+    void revertAndProgressPermutation(Cursor* cursor);
+    // Appends the letter at the given position of the given wheel to the permutation.
+    template <typename Cursor>
+    void pushLetter(size_t wheel, size_t letter, Cursor* cursor);
+    // Removes the final letter of the permutation.
+    template <typename Cursor>
+    void popLetter(Cursor* cursor);
 };
+
+/// The lettered wheels of the letters [A-Z].
+using Wheels = BasicWheels<LatinAlphabet>;
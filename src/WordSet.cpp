@@ -0,0 +1,101 @@
+#include "WordSet.h"
+
+#include <string>
+#include <vector>
+#include <bit>
+#include <cstdint>
+
+#include "FlatDictionary.h"
+
+WordSet::WordSet(const FlatDictionary& dictionary) :
+    dictionary(&dictionary), bits((dictionary.getWordIdCount() + 63) / 64, 0)
+{
+}
+
+bool WordSet::insert(FlatDictionary::WordId id)
+{
+    uint64_t& word = bits[id / 64];
+    const uint64_t bit = uint64_t(1) << (id % 64);
+
+    if(word & bit)
+    {
+        return false;
+    }
+
+    word |= bit;
+    count++;
+
+    return true;
+}
+
+bool WordSet::erase(FlatDictionary::WordId id)
+{
+    uint64_t& word = bits[id / 64];
+    const uint64_t bit = uint64_t(1) << (id % 64);
+
+    if(!(word & bit))
+    {
+        return false;
+    }
+
+    word &= ~bit;
+    count--;
+
+    return true;
+}
+
+bool WordSet::contains(FlatDictionary::WordId id) const
+{
+    return (bits[id / 64] >> (id % 64)) & 1;
+}
+
+void WordSet::merge(const WordSet& other)
+{
+    count = 0;
+
+    for(size_t i = 0; i < bits.size(); i++)
+    {
+        bits[i] |= other.bits[i];
+        count += std::popcount(bits[i]);
+    }
+}
+
+size_t WordSet::size(void) const
+{
+    return count;
+}
+
+std::vector<FlatDictionary::WordId> WordSet::getWordIds(void) const
+{
+    std::vector<FlatDictionary::WordId> ids;
+    ids.reserve(count);
+
+    for(size_t i = 0; i < bits.size(); i++)
+    {
+        // Visits each set bit, lowest id first, clearing it once visited.
+        for(uint64_t word = bits[i]; word != 0; word &= word - 1)
+        {
+            ids.push_back(static_cast<FlatDictionary::WordId>(i * 64 + std::countr_zero(word)));
+        }
+    }
+
+    return ids;
+}
+
+std::vector<std::string> WordSet::getWords(void) const
+{
+    std::vector<std::string> words;
+    words.reserve(count);
+
+    for(FlatDictionary::WordId id : getWordIds())
+    {
+        words.push_back(dictionary->getWord(id));
+    }
+
+    return words;
+}
+
+const FlatDictionary& WordSet::getDictionary(void) const
+{
+    return *dictionary;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "FlatDictionary.h"
+
+/**
+ * A collection of unique dictionary words, recorded by their word ids.
+ * 
+ * The collection is a bitmap with one bit per word id of the dictionary, so adding a word, or rejecting one already
+ * found, is a single bit test with no hashing, copying or allocation. The words are only spelled, from their ids,
+ * when they are read back.
+ * 
+ * Words are read back in word id order, whichever order the search found them in. The nodes of a trie are
+ * numbered breadth-first, so shorter words come first and words of the same length are in alphabetical order.
+ * The words of a DAWG are numbered in alphabetical order.
+ * The collection must not outlive the FlatDictionary it was created for.
+ */
+class WordSet
+{
+  public:
+    /**
+     * Constructor for an empty collection of the words of a dictionary.
+     * 
+     * @param dictionary: the dictionary the words are found in
+     */
+    explicit WordSet(const FlatDictionary& dictionary);
+    /**
+     * Adds a word.
+     * 
+     * @param id: the id of the word
+     * @return true if the word was added, false if it was already in the collection
+     */
+    bool insert(FlatDictionary::WordId id);
+    /**
+     * Removes a word.
+     * 
+     * @param id: the id of the word
+     * @return true if the word was removed, false if it was not in the collection
+     */
+    bool erase(FlatDictionary::WordId id);
+    /**
+     * Determines whether a word is in the collection.
+     * 
+     * @param id: the id of the word
+     * @return true if the word is in the collection, else false
+     */
+    bool contains(FlatDictionary::WordId id) const;
+    /**
+     * Adds every word of another collection of the same dictionary.
+     * 
+     * @param other: the collection to add the words of
+     */
+    void merge(const WordSet& other);
+    /**
+     * Gets the number of words in the collection.
+     * 
+     * @return the number of words in the collection
+     */
+    size_t size(void) const;
+    /**
+     * Gets the ids of the words, in ascending order.
+     * 
+     * @return the word ids of the words in the collection
+     */
+    std::vector<FlatDictionary::WordId> getWordIds(void) const;
+    /**
+     * Spells every word in the collection, in word id order.
+     * 
+     * @return the words in the collection, in uppercase
+     */
+    std::vector<std::string> getWords(void) const;
+    /**
+     * Gets the dictionary the words are found in.
+     * 
+     * @return the dictionary the words are found in
+     */
+    const FlatDictionary& getDictionary(void) const;
+
+  private:
+    const FlatDictionary* dictionary;
+    // One bit per word id of the dictionary, set if the word is in the collection.
+    std::vector<uint64_t> bits;
+    size_t count = 0;
+};
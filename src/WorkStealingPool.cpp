@@ -0,0 +1,135 @@
+#include "WorkStealingPool.h"
+
+#include <cstddef>
+#include <functional>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <exception>
+#include <algorithm>
+
+namespace
+{
+    // The queue of task numbers held by a single worker.
+    struct TaskQueue
+    {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+}
+
+WorkStealingPool::WorkStealingPool(size_t threads) : threadCount(threads)
+{
+    if(threadCount == 0)
+    {
+        threadCount = std::thread::hardware_concurrency();
+    }
+
+    // hardware_concurrency() may be unable to report a value.
+    if(threadCount == 0)
+    {
+        threadCount = 1;
+    }
+}
+
+size_t WorkStealingPool::getThreadCount(void) const
+{
+    return threadCount;
+}
+
+void WorkStealingPool::run(size_t taskCount, const std::function<void(size_t worker, size_t task)>& execute) const
+{
+    const size_t workers = std::min(threadCount, std::max<size_t>(taskCount, 1));
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+
+    for(size_t i = 0; i < workers; i++)
+    {
+        queues.push_back(std::make_unique<TaskQueue>());
+    }
+
+    // Deals the tasks round-robin, so each worker starts with a share of both the early and late tasks.
+    for(size_t task = 0; task < taskCount; task++)
+    {
+        queues[task % workers]->tasks.push_back(task);
+    }
+
+    std::atomic<bool> failed = false;
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+
+    auto work = [&](size_t worker)
+    {
+        while(!failed)
+        {
+            size_t task = 0;
+            bool found = false;
+
+            // Takes the next task from the worker's own queue first, then steals the last task of another queue.
+            for(size_t offset = 0; offset < workers && !found; offset++)
+            {
+                TaskQueue& queue = *queues[(worker + offset) % workers];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+
+                if(!queue.tasks.empty())
+                {
+                    if(offset == 0)
+                    {
+                        task = queue.tasks.front();
+                        queue.tasks.pop_front();
+                    }
+                    else
+                    {
+                        task = queue.tasks.back();
+                        queue.tasks.pop_back();
+                    }
+
+                    found = true;
+                }
+            }
+
+            // Tasks are never added during a run, so every queue being empty means the batch is complete.
+            if(!found)
+            {
+                return;
+            }
+
+            try
+            {
+                execute(worker, task);
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(failureMutex);
+
+                if(!failed)
+                {
+                    failure = std::current_exception();
+                    failed = true;
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    // The calling thread acts as the first worker.
+    for(size_t worker = 1; worker < workers; worker++)
+    {
+        threads.emplace_back(work, worker);
+    }
+
+    work(0);
+
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    if(failure)
+    {
+        std::rethrow_exception(failure);
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+/**
+ * Runs a batch of independent tasks across a number of threads.
+ * 
+ * Tasks are dealt round-robin to a queue per worker. A worker takes tasks from the front of its own queue and,
+ * once that is empty, steals from the back of the other workers' queues, so threads that drew cheap tasks keep
+ * helping with the expensive ones until the whole batch is complete.
+ */
+class WorkStealingPool
+{
+  public:
+    /**
+     * Constructor.
+     * 
+     * @param threads: the number of worker threads to use. 0 selects the number of hardware threads.
+     */
+    explicit WorkStealingPool(size_t threads);
+    /**
+     * Gets the number of worker threads used to run tasks.
+     * 
+     * @return the number of worker threads
+     */
+    size_t getThreadCount(void) const;
+    /**
+     * Runs the tasks numbered [0, taskCount) and returns once all of them have completed.
+     * Tasks with lower numbers are started first by each worker.
+     * 
+     * If a task throws, the remaining tasks are abandoned and the first exception is rethrown to the caller.
+     * 
+     * @param taskCount: the number of tasks to run
+     * @param execute: called with the index of the running worker, in the range [0, getThreadCount()), and the task number
+     */
+    void run(size_t taskCount, const std::function<void(size_t worker, size_t task)>& execute) const;
+
+  private:
+    size_t threadCount;
+};
@@ -0,0 +1,1073 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <set>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <filesystem>
+#include <random>
+#include <stdexcept>
+#include <memory>
+#include <cstdint>
+#include <cctype>
+#include <cstring>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "Generators.h"
+#include "Wheels.h"
+#include "Dictionary.h"
+#include "FlatDictionary.h"
+#include "DictionaryLoader.h"
+#include "DictionaryHandle.h"
+#include "Server.h"
+#include "Streaming.h"
+#include "Batch.h"
+#include "ResultWriter.h"
+#include "IncrementalSolver.h"
+#include "Search.h"
+#include "WordSet.h"
+#include "Utils.h"
+
+namespace
+{
+    /// A generated puzzle: the letters of its wheels, and the wheels and dictionary files it was written to.
+    struct Puzzle
+    {
+        std::vector<std::string> wheels;
+        std::string wheelsPath;
+        std::string dictionaryPath;
+    };
+
+    // The directory the generated files are written to.
+    const std::filesystem::path DIRECTORY = std::filesystem::temp_directory_path() / "lettered-wheels-tests";
+
+    /**
+     * Fails the running test if a condition does not hold.
+     *
+     * @param condition: the condition expected to hold
+     * @param message: the description of the failure
+     */
+    void check(bool condition, const std::string& message)
+    {
+        if(!condition)
+        {
+            throw std::runtime_error(message);
+        }
+    }
+
+    /**
+     * Writes a puzzle of wheels and a dictionary of random words to files named after the test.
+     *
+     * Random words rarely span more than a few wheels, so words spelled along the wheels are added to the dictionary,
+     * some in lowercase, some ending in "\r\n" and some with their final letter changed, to reach deep into the search.
+     *
+     * @param name: the name of the test, which prefixes the file names
+     * @param seed: the seed of the random number generators
+     * @param numberOfWheels: the number of wheels
+     * @param lettersPerWheel: the number of letters per wheel
+     * @return the puzzle written
+     */
+    Puzzle makePuzzle(const std::string& name, uint64_t seed, size_t numberOfWheels, size_t lettersPerWheel)
+    {
+        std::filesystem::create_directories(DIRECTORY);
+
+        Puzzle puzzle;
+        puzzle.wheelsPath = (DIRECTORY / (name + "-" + std::to_string(seed) + "-wheels.txt")).string();
+        puzzle.dictionaryPath = (DIRECTORY / (name + "-" + std::to_string(seed) + "-dictionary.txt")).string();
+
+        Generators generators(Generators::ENGLISH, seed);
+        generators.writeWheels(puzzle.wheelsPath, numberOfWheels, lettersPerWheel);
+        generators.writeDictionary(puzzle.dictionaryPath, 20000, 2, 8);
+
+        std::ifstream wheelsFile(puzzle.wheelsPath);
+        wheelsFile >> numberOfWheels >> lettersPerWheel;
+        puzzle.wheels.resize(numberOfWheels);
+
+        for(std::string& wheel : puzzle.wheels)
+        {
+            wheelsFile >> wheel;
+        }
+
+        std::mt19937_64 random(seed);
+        std::ofstream dictionaryFile(puzzle.dictionaryPath, std::ios::app | std::ios::binary);
+
+        for(size_t i = 0; i < 2000; i++)
+        {
+            const size_t start = random() % (numberOfWheels - 1);
+            const size_t length = 2 + random() % (numberOfWheels - start - 1);
+            std::string word;
+
+            for(size_t wheel = start; wheel < start + length; wheel++)
+            {
+                word.push_back(puzzle.wheels[wheel][random() % lettersPerWheel]);
+            }
+
+            if(i % 3 == 0)
+            {
+                std::transform(word.begin(), word.end(), word.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
+            }
+
+            if(i % 5 == 0)
+            {
+                word.back() = static_cast<char>('A' + random() % Utils::LETTERS_IN_ALPHABET);
+            }
+
+            dictionaryFile << word << (i % 7 == 0 ? "\r\n" : "\n");
+        }
+
+        return puzzle;
+    }
+
+    /**
+     * Constructs wheels from their letters.
+     *
+     * @param letters: the letters of each wheel
+     * @return the wheels
+     */
+    Wheels makeWheels(const std::vector<std::string>& letters)
+    {
+        std::stringstream text;
+        text << letters.size() << '\n' << letters[0].size() << '\n';
+
+        for(const std::string& wheel : letters)
+        {
+            text << wheel << '\n';
+        }
+
+        return Wheels(text);
+    }
+
+    /**
+     * Loads the dictionary of a puzzle, holding every word whichever wheels it is searched with.
+     *
+     * @param puzzle: the puzzle
+     * @param dawg: true to build a DAWG, false to build a trie
+     * @param imagePath: the path to write the dictionary's image to, or empty to write none
+     * @param threads: the number of threads to build a trie with
+     * @return the dictionary
+     */
+    std::unique_ptr<FlatDictionary> loadDictionary(const Puzzle& puzzle, bool dawg, const std::string& imagePath = "",
+        size_t threads = 1)
+    {
+        Utils::Options options;
+        options.dictionaryPath = puzzle.dictionaryPath;
+        options.buildIndexPath = imagePath;
+        options.dawg = dawg;
+        options.threads = threads;
+
+        return DictionaryLoader::load(options, puzzle.wheels.size());
+    }
+
+    /**
+     * Determines whether a word is spelled by a run of contiguous wheels, taking one letter from each in turn.
+     * Shares no code with Wheels, so it can check the pruning and the searches built on it.
+     *
+     * @param wheels: the letters of each wheel, in either case
+     * @param word: the word to test, in uppercase
+     * @return true if some run of wheels spells the word, else false
+     */
+    bool isFormed(const std::vector<std::string>& wheels, const std::string& word)
+    {
+        for(size_t start = 0; start + word.length() <= wheels.size(); start++)
+        {
+            size_t length = 0;
+
+            while(length < word.length() && std::any_of(wheels[start + length].begin(), wheels[start + length].end(),
+                [&](char letter) { return std::toupper(letter) == word[length]; }))
+            {
+                length++;
+            }
+
+            if(length == word.length())
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Finds the words of a puzzle by testing every dictionary word against the wheels, without any search.
+     *
+     * @param puzzle: the puzzle
+     * @return the words of at least two letters formed by the wheels, in uppercase
+     */
+    std::set<std::string> bruteForce(const Puzzle& puzzle)
+    {
+        std::ifstream file(puzzle.dictionaryPath);
+        std::set<std::string> words;
+        std::string word;
+
+        while(std::getline(file, word))
+        {
+            if(!word.empty() && word.back() == '\r')
+            {
+                word.pop_back();
+            }
+
+            std::transform(word.begin(), word.end(), word.begin(), [](char c) { return static_cast<char>(std::toupper(c)); });
+
+            if(word.length() > 1 && isFormed(puzzle.wheels, word))
+            {
+                words.insert(word);
+            }
+        }
+
+        return words;
+    }
+
+    /**
+     * Spells the words of a collection.
+     *
+     * @param result: the collection of words
+     * @return the words, in uppercase
+     */
+    std::set<std::string> spell(const WordSet& result)
+    {
+        const std::vector<std::string> words = result.getWords();
+
+        return std::set<std::string>(words.begin(), words.end());
+    }
+
+    /**
+     * Fails the running test if a search did not find exactly the expected words.
+     *
+     * @param result: the words found by the search
+     * @param expected: the words the search should find
+     * @param name: the description of the search
+     */
+    void checkWords(const WordSet& result, const std::set<std::string>& expected, const std::string& name)
+    {
+        check(spell(result) == expected, name + " found " + std::to_string(result.size()) + " words, expected "
+            + std::to_string(expected.size()) + ".");
+    }
+
+    /**
+     * Spells the output the CLI writes for a search.
+     *
+     * @param words: the words found, in the order they are written
+     * @param isJson: true for JSON lines, false for text
+     * @return the words, one per line, followed by the count line
+     */
+    std::string formatOutput(const std::vector<std::string>& words, bool isJson)
+    {
+        std::string output;
+
+        for(const std::string& word : words)
+        {
+            output += isJson ? "{\"word\":\"" + word + "\"}\n" : word + "\n";
+        }
+
+        return output + (isJson ? "{\"found\":" + std::to_string(words.size()) + "}\n"
+            : "Found " + std::to_string(words.size()) + " unique words\n");
+    }
+
+    /**
+     * Reads a whole file.
+     *
+     * @param path: the path of the file
+     * @return the contents of the file
+     */
+    std::string readFile(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream contents;
+        contents << file.rdbuf();
+
+        return contents.str();
+    }
+
+#ifndef _WIN32
+    /**
+     * Sends requests to a server over a new connection, then ends the connection for writing and reads every response.
+     *
+     * @param socketPath: the path of the server's Unix domain socket
+     * @param requests: the requests, sent in a single write
+     * @return everything the server wrote before it ended the connection
+     */
+    std::string sendRequests(const std::string& socketPath, const std::string& requests)
+    {
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+        const int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+        check(connection >= 0 && connect(connection, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0,
+            "Unable to connect to the server.");
+        check(send(connection, requests.data(), requests.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(requests.size()),
+            "Unable to send the requests.");
+        shutdown(connection, SHUT_WR);
+
+        std::string responses;
+        char chunk[4096];
+        ssize_t received;
+
+        while((received = recv(connection, chunk, sizeof(chunk), 0)) > 0)
+        {
+            responses.append(chunk, static_cast<size_t>(received));
+        }
+
+        close(connection);
+
+        return responses;
+    }
+
+    /// Runs a server on its own thread. The server is stopped and its thread joined on destruction, even if a check fails.
+    class ServerRunner
+    {
+      public:
+        explicit ServerRunner(Server& server) : server(server), thread([&server] { server.run(); }) {}
+
+        ~ServerRunner(void)
+        {
+            server.stop();
+            thread.join();
+        }
+
+      private:
+        Server& server;
+        std::thread thread;
+    };
+#endif
+
+    // Every engine, thread count and dictionary layout finds the words the wheels can form.
+    void testEngines(void)
+    {
+        for(uint64_t seed = 1; seed <= 3; seed++)
+        {
+            const Puzzle puzzle = makePuzzle("engines", seed, 9 + 2 * seed, 6);
+            const Wheels wheels = makeWheels(puzzle.wheels);
+            const std::set<std::string> expected = bruteForce(puzzle);
+
+            check(std::any_of(expected.begin(), expected.end(), [](const std::string& word) { return word.length() >= 6; }),
+                "The generated puzzle forms no long word.");
+
+            for(bool dawg : { false, true })
+            {
+                const std::unique_ptr<FlatDictionary> dictionary = loadDictionary(puzzle, dawg);
+                const std::string layout = dawg ? " with --dawg" : "";
+
+                for(bool memoize : { false, true })
+                {
+                    Wheels traversal = wheels;
+                    const std::string name = memoize ? "dfs --memoize" : "dfs";
+
+                    checkWords(Search::sequential(traversal, *dictionary, memoize), expected, name + layout);
+                    checkWords(Search::parallel(wheels, *dictionary, 3, memoize), expected, name + " --threads 3" + layout);
+                }
+
+                for(size_t threads : { 1, 3 })
+                {
+                    const std::string suffix = " --threads " + std::to_string(threads) + layout;
+
+                    checkWords(Search::bitmask(wheels, *dictionary, threads), expected, "bitmask" + suffix);
+                    checkWords(Search::multiStart(wheels, *dictionary, threads), expected, "multistart" + suffix);
+                }
+            }
+        }
+    }
+
+    // A trie built by several threads is identical to one built by a single thread, and every builder reports the
+    // first invalid word in the file.
+    void testBuild(void)
+    {
+        Puzzle puzzle = makePuzzle("build", 1, 12, 6);
+        const Wheels wheels = makeWheels(puzzle.wheels);
+        const std::set<std::string> expected = bruteForce(puzzle);
+        const std::unique_ptr<FlatDictionary> single = loadDictionary(puzzle, false);
+
+        for(size_t threads : { 2, 4, 7 })
+        {
+            const std::unique_ptr<FlatDictionary> sharded = loadDictionary(puzzle, false, "", threads);
+            const std::string name = "The trie built with " + std::to_string(threads) + " threads";
+
+            check(sharded->getNodeCount() == single->getNodeCount() && sharded->getWordIdCount() == single->getWordIdCount(),
+                name + " does not have the size of the trie built with one thread.");
+
+            for(FlatDictionary::WordId id = 0; id < sharded->getWordIdCount(); id++)
+            {
+                check(sharded->getWord(id) == single->getWord(id), name + " spells word " + std::to_string(id) + " differently.");
+            }
+
+            checkWords(Search::bitmask(wheels, *sharded, 1), expected, "bitmask on " + name);
+        }
+
+        // The first invalid word is near the start of the file, and a second one sorts before it, near the end.
+        std::ifstream original(puzzle.dictionaryPath);
+        std::stringstream contents;
+        contents << original.rdbuf();
+        original.close();
+
+        puzzle.dictionaryPath = (DIRECTORY / "build-invalid-dictionary.txt").string();
+        std::ofstream(puzzle.dictionaryPath, std::ios::binary) << "AB\nq1\n" << contents.str() << "A2\n";
+
+        for(size_t threads : { 1, 4 })
+        {
+            for(bool dawg : { false, true })
+            {
+                if(dawg && threads > 1)
+                {
+                    continue;
+                }
+
+                std::string error;
+
+                try
+                {
+                    loadDictionary(puzzle, dawg, "", threads);
+                }
+                catch(const std::invalid_argument& e)
+                {
+                    error = e.what();
+                }
+
+                check(error.find("\"q1\"") != std::string::npos, std::string(dawg ? "The DAWG" : "The trie") + " built with "
+                    + std::to_string(threads) + " threads reported \"" + error + "\", not the first invalid word.");
+            }
+        }
+    }
+
+    // A dictionary saved as an image and mapped back holds the same words, in both layouts. A damaged image is rejected.
+    void testImage(void)
+    {
+        const Puzzle puzzle = makePuzzle("image", 1, 12, 6);
+        const Wheels wheels = makeWheels(puzzle.wheels);
+        const std::set<std::string> expected = bruteForce(puzzle);
+
+        for(bool dawg : { false, true })
+        {
+            const std::string path = (DIRECTORY / (dawg ? "image-dawg.idx" : "image-trie.idx")).string();
+            const std::unique_ptr<FlatDictionary> built = loadDictionary(puzzle, dawg, path);
+            const FlatDictionary loaded = FlatDictionary::load(path);
+            const std::string layout = dawg ? "DAWG" : "trie";
+
+            check(loaded.getLayout() == built->getLayout(), "The " + layout + " image has the wrong layout.");
+            check(loaded.getNodeCount() == built->getNodeCount() && loaded.getWordIdCount() == built->getWordIdCount()
+                && loaded.getMaximumWordSize() == built->getMaximumWordSize()
+                && loaded.getLongestWordSize() == built->getLongestWordSize(),
+                "The " + layout + " image does not have the size of the dictionary it was saved from.");
+
+            for(FlatDictionary::WordId id = 0; id < loaded.getWordIdCount(); id++)
+            {
+                check(loaded.getWord(id) == built->getWord(id), "The " + layout + " image spells word " + std::to_string(id) + " differently.");
+            }
+
+            checkWords(Search::bitmask(wheels, loaded, 1), expected, "bitmask on the " + layout + " image");
+
+            // Cuts the image short, after its header.
+            const std::string damagedPath = path + ".damaged";
+            std::filesystem::copy_file(path, damagedPath, std::filesystem::copy_options::overwrite_existing);
+            std::filesystem::resize_file(damagedPath, std::filesystem::file_size(path) / 2);
+
+            bool isRejected = false;
+
+            try
+            {
+                FlatDictionary::load(damagedPath);
+            }
+            catch(const std::invalid_argument&)
+            {
+                isRejected = true;
+            }
+
+            check(isRejected, "A truncated " + layout + " image was loaded.");
+        }
+    }
+
+    // Each wheel replacement leaves the incremental result equal to a fresh search of the new wheels.
+    void testIncremental(void)
+    {
+        Puzzle puzzle = makePuzzle("incremental", 1, 14, 6);
+        const std::unique_ptr<FlatDictionary> dictionary = loadDictionary(puzzle, false);
+        IncrementalSolver solver(makeWheels(puzzle.wheels), *dictionary);
+        std::mt19937_64 random(1);
+
+        checkWords(solver.getResult(), bruteForce(puzzle), "The initial incremental search");
+
+        for(size_t replacement = 0; replacement < 40; replacement++)
+        {
+            const size_t wheel = random() % puzzle.wheels.size();
+            // Most replacements take the letters of another wheel, so the words spelled along the wheels move.
+            std::string letters = puzzle.wheels[random() % puzzle.wheels.size()];
+
+            std::shuffle(letters.begin(), letters.end(), random);
+            letters[0] = static_cast<char>('a' + random() % Utils::LETTERS_IN_ALPHABET);
+
+            const std::set<std::string> before = spell(solver.getResult());
+            const IncrementalSolver::Change change = solver.replaceWheel(wheel, letters);
+            puzzle.wheels[wheel] = letters;
+
+            const Wheels replaced = makeWheels(puzzle.wheels);
+            const std::set<std::string> after = spell(Search::bitmask(replaced, *dictionary, 1));
+            const std::string name = "Replacement " + std::to_string(replacement);
+
+            checkWords(solver.getResult(), after, name);
+
+            std::set<std::string> edited = before;
+
+            for(FlatDictionary::WordId id : change.removed)
+            {
+                check(edited.erase(dictionary->getWord(id)) == 1, name + " removed a word that was not found.");
+            }
+
+            for(FlatDictionary::WordId id : change.added)
+            {
+                check(edited.insert(dictionary->getWord(id)).second, name + " added a word that was already found.");
+            }
+
+            check(edited == after, name + " reported changes that do not lead to the new result.");
+        }
+
+        // A malformed replacement is rejected and leaves the result unchanged.
+        const std::set<std::string> before = spell(solver.getResult());
+        bool isRejected = false;
+
+        try
+        {
+            solver.replaceWheel(0, "ABC");
+        }
+        catch(const std::invalid_argument&)
+        {
+            isRejected = true;
+        }
+
+        check(isRejected && spell(solver.getResult()) == before, "A replacement of the wrong length was applied.");
+    }
+
+    // The ranked queries find the words a filter of every word found would keep.
+    void testRanked(void)
+    {
+        const Puzzle puzzle = makePuzzle("ranked", 2, 13, 6);
+        const Wheels wheels = makeWheels(puzzle.wheels);
+        const std::set<std::string> words = bruteForce(puzzle);
+
+        // Longest first, ties going to the alphabetically first.
+        std::vector<std::string> ranking(words.begin(), words.end());
+        std::stable_sort(ranking.begin(), ranking.end(), [](const std::string& first, const std::string& second)
+        {
+            return first.length() > second.length();
+        });
+
+        struct Query
+        {
+            size_t minimumLength;
+            size_t topK;
+            bool longest;
+        };
+
+        for(const Query& query : { Query{ 4, 0, false }, Query{ 9, 0, false }, Query{ 0, 1, false }, Query{ 0, 5, false },
+            Query{ 0, 50, false }, Query{ 5, 20, false }, Query{ 0, 0, true }, Query{ 3, 0, true }, Query{ 40, 0, false } })
+        {
+            std::set<std::string> expected;
+
+            for(const std::string& word : ranking)
+            {
+                const bool isLongest = word.length() == ranking.front().length();
+
+                if(word.length() >= query.minimumLength && (!query.longest || isLongest)
+                    && (query.topK == 0 || expected.size() < query.topK))
+                {
+                    expected.insert(word);
+                }
+            }
+
+            Utils::Options options;
+            options.minimumLength = query.minimumLength;
+            options.topK = query.topK;
+            options.longest = query.longest;
+
+            const std::string name = "--min-length " + std::to_string(query.minimumLength) + " --top-k "
+                + std::to_string(query.topK) + (query.longest ? " --longest" : "");
+
+            for(bool dawg : { false, true })
+            {
+                const std::unique_ptr<FlatDictionary> dictionary = loadDictionary(puzzle, dawg);
+
+                for(size_t threads : { 1, 3 })
+                {
+                    checkWords(Search::ranked(wheels, *dictionary, options, threads), expected,
+                        name + " --threads " + std::to_string(threads) + (dawg ? " with --dawg" : ""));
+                }
+            }
+        }
+    }
+
+    // The generator yields each word once, and a consumer that stops early gets the first words of the full sequence.
+    void testGenerate(void)
+    {
+        const Puzzle puzzle = makePuzzle("generate", 3, 12, 6);
+        const Wheels wheels = makeWheels(puzzle.wheels);
+        const std::set<std::string> expected = bruteForce(puzzle);
+        const std::unique_ptr<FlatDictionary> dictionary = loadDictionary(puzzle, false);
+
+        for(bool memoize : { false, true })
+        {
+            std::vector<std::string> sequence;
+
+            for(std::string_view word : Search::generate(wheels, *dictionary, memoize))
+            {
+                sequence.emplace_back(word);
+            }
+
+            check(sequence.size() == expected.size() && std::set<std::string>(sequence.begin(), sequence.end()) == expected,
+                "The generator yielded " + std::to_string(sequence.size()) + " words, expected the "
+                + std::to_string(expected.size()) + " words found.");
+
+            for(size_t count : { size_t(1), size_t(10), sequence.size() / 2 })
+            {
+                std::vector<std::string> first;
+
+                for(std::string_view word : Search::generate(wheels, *dictionary, memoize))
+                {
+                    first.emplace_back(word);
+
+                    if(first.size() == count)
+                    {
+                        break;
+                    }
+                }
+
+                check(std::equal(first.begin(), first.end(), sequence.begin()) && first.size() == count,
+                    "Stopping the generator after " + std::to_string(count) + " words did not give the first words.");
+
+                std::vector<std::string> handed;
+                const size_t total = Search::forEach(wheels, *dictionary, [&](std::string_view word)
+                {
+                    handed.emplace_back(word);
+                    return handed.size() < count;
+                }, memoize);
+
+                check(total == count && handed == first,
+                    "forEach handed " + std::to_string(handed.size()) + " words after asking to stop at " + std::to_string(count) + ".");
+            }
+        }
+    }
+
+    // Pruning the dictionary with the wheels keeps exactly the words they form, in both layouts.
+    void testPruning(void)
+    {
+        const Puzzle puzzle = makePuzzle("pruning", 1, 12, 6);
+        const Wheels wheels = makeWheels(puzzle.wheels);
+        const std::set<std::string> expected = bruteForce(puzzle);
+
+        std::ifstream file(puzzle.dictionaryPath);
+        std::string word;
+
+        while(std::getline(file, word))
+        {
+            if(!word.empty() && word.back() == '\r')
+            {
+                word.pop_back();
+            }
+
+            std::string upper = word;
+            std::transform(upper.begin(), upper.end(), upper.begin(), [](char c) { return static_cast<char>(std::toupper(c)); });
+
+            check(wheels.canForm(word) == isFormed(puzzle.wheels, upper), "canForm is wrong for the word \"" + word + "\".");
+        }
+
+        for(bool dawg : { false, true })
+        {
+            Utils::Options options;
+            options.dictionaryPath = puzzle.dictionaryPath;
+            options.dawg = dawg;
+
+            const std::unique_ptr<FlatDictionary> dictionary = DictionaryLoader::load(options, wheels.getNumberOfWheels(), &wheels);
+            const std::string layout = dawg ? "The pruned DAWG" : "The pruned trie";
+            std::set<std::string> words;
+
+            for(FlatDictionary::WordId id = 0; id < dictionary->getWordIdCount(); id++)
+            {
+                dictionary->getWord(id, word);
+
+                const Dictionary::SEARCH_STATUS status = dictionary->find(word);
+
+                if(word.length() > 1 && (status == Dictionary::HIT_TERMINAL || status == Dictionary::HIT_PARENT))
+                {
+                    words.insert(word);
+                }
+            }
+
+            check(words == expected, layout + " holds " + std::to_string(words.size()) + " words, expected the "
+                + std::to_string(expected.size()) + " words the wheels form.");
+            checkWords(Search::bitmask(wheels, *dictionary, 1), expected, "bitmask on " + layout);
+        }
+    }
+
+    // The output holds every word once, in node order or sorted, as text or JSON lines, or only the count.
+    void testOutput(void)
+    {
+        const Puzzle puzzle = makePuzzle("output", 1, 12, 6);
+        const std::set<std::string> expected = bruteForce(puzzle);
+        const std::vector<std::string> sorted(expected.begin(), expected.end());
+        const std::unique_ptr<FlatDictionary> dictionary = loadDictionary(puzzle, false);
+        const WordSet result = Search::bitmask(makeWheels(puzzle.wheels), *dictionary, 1);
+
+        for(bool isJson : { false, true })
+        {
+            const std::string format = isJson ? " as JSON lines" : " as text";
+            Utils::Options options;
+            options.format = isJson ? Utils::Options::JSON_LINES : Utils::Options::TEXT;
+
+            std::ostringstream output;
+            ResultWriter::write(result, options, output);
+            check(output.str() == formatOutput(result.getWords(), isJson), "The words were not written in node order" + format + ".");
+
+            options.sortOutput = true;
+            output.str("");
+            ResultWriter::write(result, options, output);
+            check(output.str() == formatOutput(sorted, isJson), "The words were not written sorted" + format + ".");
+
+            options.countOnly = true;
+            output.str("");
+            ResultWriter::write(result, options, output);
+            check(output.str() == (isJson ? "{\"found\":" + std::to_string(sorted.size()) + "}\n"
+                : "Found " + std::to_string(sorted.size()) + " unique words\n"), "--count-only wrote more than the count" + format + ".");
+        }
+
+        // The radix sort places a word before the longer words it prefixes, as std::sort does.
+        std::vector<std::string> words = sorted;
+        words.insert(words.end(), { "A", "AB", "ABC", "ABCZ", "ZZZZZZZZZZ", "ZZ" });
+        std::shuffle(words.begin(), words.end(), std::mt19937_64(1));
+
+        std::vector<std::string> reference = words;
+        std::sort(reference.begin(), reference.end());
+        ResultWriter::sort(words);
+
+        check(words == reference, "ResultWriter::sort does not sort alphabetically.");
+    }
+
+    // Streaming the wheels finds each word the wheels form once, reading only the declared wheels.
+    void testStreaming(void)
+    {
+        const Puzzle puzzle = makePuzzle("streaming", 1, 14, 6);
+        const std::set<std::string> expected = bruteForce(puzzle);
+
+        Utils::Options options;
+        options.dictionaryPath = puzzle.dictionaryPath;
+
+        const std::unique_ptr<FlatDictionary> dictionary = DictionaryLoader::load(options, SIZE_MAX);
+        // Anything after the declared wheels, even an invalid line, is left unread.
+        std::istringstream wheelsFile(readFile(puzzle.wheelsPath) + "A1\n");
+        std::ostringstream output;
+
+        check(Streaming::solve(wheelsFile, *dictionary, options, output) == expected.size(),
+            "Streaming counted the wrong number of words.");
+
+        std::vector<std::string> words;
+        std::istringstream lines(output.str());
+        std::string line;
+
+        while(std::getline(lines, line))
+        {
+            words.push_back(line);
+        }
+
+        check(!words.empty() && words.back() == "Found " + std::to_string(expected.size()) + " unique words",
+            "Streaming did not end with the count line.");
+        words.pop_back();
+        check(words.size() == expected.size() && std::set<std::string>(words.begin(), words.end()) == expected,
+            "Streaming wrote " + std::to_string(words.size()) + " words, expected the " + std::to_string(expected.size())
+            + " words the wheels form, each once.");
+
+        options.countOnly = true;
+        options.format = Utils::Options::JSON_LINES;
+        wheelsFile.clear();
+        wheelsFile.seekg(0);
+        output.str("");
+        Streaming::solve(wheelsFile, *dictionary, options, output);
+        check(output.str() == "{\"found\":" + std::to_string(expected.size()) + "}\n", "Streaming with --count-only wrote more than the count.");
+
+        bool isRejected = false;
+
+        try
+        {
+            std::istringstream malformed("2\n3\nABC\nA1C\n");
+            Streaming::solve(malformed, *dictionary, options, output);
+        }
+        catch(const std::invalid_argument&)
+        {
+            isRejected = true;
+        }
+
+        check(isRejected, "Streaming accepted a wheel holding an invalid letter.");
+    }
+
+    // A batch writes each puzzle's result in list order, and skips puzzles that cannot be read or written.
+    void testBatch(void)
+    {
+        Puzzle first = makePuzzle("batch", 1, 12, 6);
+        Puzzle second = makePuzzle("batch", 2, 9, 5);
+        // Every puzzle of a batch is solved against the same dictionary.
+        second.dictionaryPath = first.dictionaryPath;
+
+        const std::string batchPath = (DIRECTORY / "batch.txt").string();
+        const std::string missingPath = (DIRECTORY / "batch-missing-wheels.txt").string();
+        std::ofstream(batchPath) << first.wheelsPath << "\n" << missingPath << "\r\n\n" << second.wheelsPath << "\n" << first.wheelsPath << "\n";
+
+        const auto expectedOutput = [](const Puzzle& puzzle)
+        {
+            const std::set<std::string> words = bruteForce(puzzle);
+
+            return formatOutput(std::vector<std::string>(words.begin(), words.end()), false);
+        };
+
+        Utils::Options options;
+        options.batchPath = batchPath;
+        options.dictionaryPath = first.dictionaryPath;
+        options.sortOutput = true;
+        options.threads = 3;
+
+        // The results are written to the console, which is captured.
+        std::ostringstream console;
+        std::streambuf* const standardOutput = std::cout.rdbuf(console.rdbuf());
+        size_t failures = 0;
+
+        try
+        {
+            failures = Batch::solve(options);
+        }
+        catch(...)
+        {
+            std::cout.rdbuf(standardOutput);
+            throw;
+        }
+
+        std::cout.rdbuf(standardOutput);
+
+        check(failures == 1, "The batch reported " + std::to_string(failures) + " failures, expected the missing puzzle.");
+        check(console.str() == "Puzzle: " + first.wheelsPath + "\n" + expectedOutput(first) + "Puzzle: " + second.wheelsPath
+            + "\n" + expectedOutput(second) + "Puzzle: " + first.wheelsPath + "\n" + expectedOutput(first),
+            "The batch did not write each result in list order.");
+
+        // The final result cannot be written, as a directory takes its name.
+        const std::filesystem::path outputDirectory = DIRECTORY / "batch-results";
+        std::filesystem::remove_all(outputDirectory);
+        std::filesystem::create_directories(outputDirectory / "3-batch-1-wheels.txt");
+        options.outputDirectory = outputDirectory.string();
+
+        failures = Batch::solve(options);
+
+        check(failures == 2, "The batch reported " + std::to_string(failures) + " failures, expected the missing puzzle and the unwritable result.");
+        check(readFile((outputDirectory / "0-batch-1-wheels.txt").string()) == expectedOutput(first)
+            && readFile((outputDirectory / "2-batch-2-wheels.txt").string()) == expectedOutput(second),
+            "The batch did not write each result to its own file.");
+    }
+
+    // The server answers pipelined requests in order, with the output the CLI writes, and answers malformed or
+    // truncated requests with an error.
+    void testServer(void)
+    {
+#ifndef _WIN32
+        const Puzzle puzzle = makePuzzle("server", 1, 12, 6);
+        const Puzzle other = makePuzzle("server", 2, 10, 5);
+        const std::set<std::string> expected = bruteForce(puzzle);
+        const std::string request = readFile(puzzle.wheelsPath);
+        const std::string otherRequest = readFile(other.wheelsPath);
+        // The second request is sent with "\r\n" line endings.
+        std::string otherLines;
+
+        for(char c : otherRequest)
+        {
+            otherLines += c == '\n' ? "\r\n" : std::string(1, c);
+        }
+
+        Utils::Options options;
+        options.dictionaryPath = puzzle.dictionaryPath;
+        options.sortOutput = true;
+
+        DictionaryHandle dictionary(DictionaryLoader::load(options, SIZE_MAX));
+        const std::string response = Server::respond(*dictionary.acquire(), request, options);
+
+        check(response == "OK " + std::to_string(expected.size()) + "\n"
+            + formatOutput(std::vector<std::string>(expected.begin(), expected.end()), false),
+            "The response does not hold the words the wheels form, sorted.");
+        check(Server::respond(*dictionary.acquire(), "2\n3\nABC\n", options)
+            == "ERROR The request must contain 2 wheels of exactly 3 letters.\n", "A request missing a wheel was answered.");
+        check(Server::respond(*dictionary.acquire(), "2\n3\nABC\nA1C\n", options).rfind("ERROR ", 0) == 0,
+            "A request holding an invalid letter was answered.");
+
+        const std::string socketPath = (DIRECTORY / "server.sock").string();
+        Server server(dictionary, "unix:" + socketPath, options);
+        const ServerRunner runner(server);
+
+        // Blank lines may separate pipelined requests.
+        check(sendRequests(socketPath, request + "\n" + otherLines + request)
+            == response + Server::respond(*dictionary.acquire(), otherRequest, options) + response,
+            "The pipelined requests were not answered in order.");
+        check(sendRequests(socketPath, "3\n4\nABCD\n") == "ERROR The request must contain 3 wheels of exactly 4 letters.\n",
+            "A truncated request was not answered with an error.");
+        // The following request cannot be located, so the connection ends after the error.
+        const std::string error = sendRequests(socketPath, "3\nx\n" + request);
+        check(error.rfind("ERROR ", 0) == 0 && error.find('\n') == error.size() - 1,
+            "A request with a malformed header was not answered with a single error.");
+#endif
+    }
+
+    // A dictionary replaced while snapshots of it are in use stays valid until they end, and the server answers
+    // with a changed dictionary file once it is reloaded.
+    void testReload(void)
+    {
+        const auto build = [](const std::vector<std::string>& words)
+        {
+            Dictionary trie;
+
+            for(const std::string& word : words)
+            {
+                trie.insert(word);
+            }
+
+            return std::make_unique<FlatDictionary>(trie);
+        };
+
+        DictionaryHandle handle(build({ "AB", "CD" }));
+        {
+            const DictionaryHandle::Snapshot snapshot = handle.acquire();
+            handle.publish(build({ "EF" }));
+
+            check(snapshot->find("CD") == Dictionary::HIT_TERMINAL && snapshot->find("EF") == Dictionary::MISS,
+                "A snapshot changed when a dictionary was published.");
+            check(handle.acquire()->find("EF") == Dictionary::HIT_TERMINAL, "A snapshot acquired after a publish has the replaced dictionary.");
+        }
+
+        // Readers acquire snapshots while the dictionary is replaced, and each sees one whole dictionary.
+        std::atomic<bool> isPublishing = true;
+        std::atomic<size_t> torn = 0;
+        std::vector<std::thread> readers;
+
+        for(size_t reader = 0; reader < 4; reader++)
+        {
+            readers.emplace_back([&]
+            {
+                while(isPublishing)
+                {
+                    const DictionaryHandle::Snapshot snapshot = handle.acquire();
+                    const bool isFirst = snapshot->find("GHI") == Dictionary::HIT_TERMINAL;
+
+                    if(isFirst == (snapshot->find("EF") == Dictionary::HIT_TERMINAL) || isFirst != (snapshot->find("AB") == Dictionary::HIT_TERMINAL))
+                    {
+                        torn++;
+                    }
+                }
+            });
+        }
+
+        for(size_t publish = 0; publish < 2000; publish++)
+        {
+            handle.publish(publish % 2 == 0 ? build({ "AB", "CD", "GHI" }) : build({ "EF" }));
+        }
+
+        isPublishing = false;
+
+        for(std::thread& reader : readers)
+        {
+            reader.join();
+        }
+
+        check(torn == 0, std::to_string(torn) + " snapshots held a dictionary that was never published.");
+
+#ifndef _WIN32
+        // The server rebuilds the dictionary once its file changes, and answers the following requests with it.
+        Puzzle puzzle = makePuzzle("reload", 1, 12, 6);
+        const std::string request = readFile(puzzle.wheelsPath);
+        const std::string dictionaryPath = (DIRECTORY / "reload-served-dictionary.txt").string();
+        std::filesystem::copy_file(puzzle.dictionaryPath, dictionaryPath, std::filesystem::copy_options::overwrite_existing);
+
+        Utils::Options options;
+        options.dictionaryPath = dictionaryPath;
+        options.countOnly = true;
+        options.reloadSeconds = 1;
+
+        DictionaryHandle dictionary(DictionaryLoader::load(options, SIZE_MAX));
+        const std::string socketPath = (DIRECTORY / "reload.sock").string();
+        Server server(dictionary, "unix:" + socketPath, options);
+        const ServerRunner runner(server);
+
+        check(sendRequests(socketPath, request) == "OK " + std::to_string(bruteForce(puzzle).size()) + "\nFound "
+            + std::to_string(bruteForce(puzzle).size()) + " unique words\n", "The server did not answer with the dictionary file.");
+
+        // Keeps the first half of the words, and moves the modification time on so the change is seen at once.
+        const std::string contents = readFile(dictionaryPath);
+        const auto writeTime = std::filesystem::last_write_time(dictionaryPath);
+        std::ofstream(dictionaryPath, std::ios::binary | std::ios::trunc) << contents.substr(0, contents.find('\n', contents.size() / 2) + 1);
+        std::filesystem::last_write_time(dictionaryPath, writeTime + std::chrono::seconds(10));
+
+        puzzle.dictionaryPath = dictionaryPath;
+        const size_t count = bruteForce(puzzle).size();
+        const std::string expected = "OK " + std::to_string(count) + "\nFound " + std::to_string(count) + " unique words\n";
+        bool isReloaded = false;
+
+        for(size_t attempt = 0; attempt < 100 && !isReloaded; attempt++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            isReloaded = sendRequests(socketPath, request) == expected;
+        }
+
+        check(isReloaded, "The server did not answer with the changed dictionary file within 10 seconds.");
+#endif
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const std::vector<std::pair<std::string, std::function<void(void)>>> tests = {
+        { "engines", testEngines },
+        { "build", testBuild },
+        { "image", testImage },
+        { "incremental", testIncremental },
+        { "ranked", testRanked },
+        { "generate", testGenerate },
+        { "pruning", testPruning },
+        { "output", testOutput },
+        { "streaming", testStreaming },
+        { "batch", testBatch },
+        { "server", testServer },
+        { "reload", testReload }
+    };
+
+    size_t run = 0;
+    size_t failures = 0;
+
+    // Runs the test named by the CLI argument, or every test if none is named.
+    for(const auto& [name, test] : tests)
+    {
+        if(argc > 1 && name != argv[1])
+        {
+            continue;
+        }
+
+        run++;
+
+        try
+        {
+            test();
+            std::cout << "PASS " << name << std::endl;
+        }
+        catch(const std::exception& e)
+        {
+            std::cerr << "FAIL " << name << ": " << e.what() << std::endl;
+            failures++;
+        }
+    }
+
+    if(run == 0)
+    {
+        std::cerr << "Unknown test: " << argv[1] << std::endl;
+        return 1;
+    }
+
+    return failures == 0 ? 0 : 1;
+}